@@ -5,6 +5,8 @@
 #include <cstring>
 #include <iostream>
 
+#include "fast_output.hpp"
+
 namespace LegacyCode
 {
     class Paragraph
@@ -72,7 +74,7 @@ namespace LegacyCode
 
         void render_at(int posx, int posy) const
         {
-            std::cout << "Rendering text '" << buffer_ << "' at: [" << posx << ", " << posy << "]" << std::endl;
+            FastOutput::Writer{} << "Rendering text '" << buffer_ << "' at: [" << posx << ", " << posy << "]" << FastOutput::endl;
         }
 
         virtual ~Paragraph()
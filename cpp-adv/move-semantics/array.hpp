@@ -0,0 +1,401 @@
+#ifndef ARRAY_HPP_
+#define ARRAY_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "event_log.hpp"
+#include "fast_output.hpp"
+
+// specialized for lazy expressions over Array (see array_expr.hpp)
+template <typename T>
+struct IsArrayExpression : std::false_type
+{
+};
+
+template <typename T>
+constexpr bool IsArrayExpression_v = IsArrayExpression<T>::value;
+
+// lifetime tracing of arrays - on by default, can be switched off for benchmarks & stress tests
+namespace ArrayTracing
+{
+	inline std::atomic<bool> enabled{ true };
+
+	inline bool is_enabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	// event to EventLog while it records (no output, no lock), a line of text otherwise
+	inline void trace(EventLog::EventType type, const void* address, const char* text)
+	{
+		if (is_enabled() && !EventLog::record(type, address, text))
+			FastOutput::Writer{} << text << '\n';
+	}
+
+	// disables tracing in a scope
+	class Disable
+	{
+		bool previous_;
+
+	public:
+		Disable() : previous_{ enabled.exchange(false) }
+		{
+		}
+
+		Disable(const Disable&) = delete;
+		Disable& operator=(const Disable&) = delete;
+
+		~Disable()
+		{
+			enabled = previous_;
+		}
+	};
+}
+
+// Storage policy - where the elements of BasicArray live
+struct HeapStorage
+{
+	template <typename T>
+	static T* allocate(size_t size)
+	{
+		return static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t{ alignof(T) }));
+	}
+
+	template <typename T>
+	static void deallocate(T* data, size_t /*size*/) noexcept
+	{
+		::operator delete(data, std::align_val_t{ alignof(T) });
+	}
+
+	template <typename T>
+	static void uninitialized_fill(T* data, size_t size, const T& value)
+	{
+		std::uninitialized_fill_n(data, size, value);
+	}
+};
+
+// Elements live in raw storage:
+// - trivially copyable T is copied with memcpy
+// - destructors are not called for trivially destructible T
+// - other types are copied/moved element by element
+template <typename T, typename TStorage = HeapStorage>
+class BasicArray
+{
+private:
+	size_t size_;
+	T* data_;
+
+	struct Uninitialized {};
+
+	// allocates storage & constructs elements with init(data_, size_) - storage is released if init throws
+	template <typename TInit>
+	BasicArray(Uninitialized, size_t size, TInit init)
+		: size_(size), data_(allocate(size))
+	{
+		try
+		{
+			init(data_, size_);
+		}
+		catch (...)
+		{
+			deallocate(data_, size_);
+			throw;
+		}
+	}
+
+public:
+	typedef T* iterator; // legacy style
+	using const_iterator = const T*; // since C++11
+	using value_type = T;
+
+									   // allows list initialization: Array a = {1, 2, 3}
+	BasicArray(std::initializer_list<T> il)
+		: BasicArray(Uninitialized{}, il.size(), [&il](T* target, size_t size) { copy_construct(il.begin(), size, target); })
+	{
+		if (ArrayTracing::is_enabled() && !EventLog::record(EventLog::EventType::Construct, this, "Array(initializer_list)"))
+		{
+			FastOutput::Writer out;
+			out << "Array({ ";
+			for (const auto& item : il)
+				out << item << " ";
+			out << "})\n";
+		}
+	}
+
+	explicit BasicArray(size_t size, const T& value = T())
+		: BasicArray(Uninitialized{}, size, [&value](T* target, size_t size) { TStorage::uninitialized_fill(target, size, value); })
+	{
+		if (ArrayTracing::is_enabled() && !EventLog::record(EventLog::EventType::Construct, this, "Array(size)"))
+			FastOutput::Writer{} << "Array(size: " << size_ << ")\n";
+	}
+
+	// BasicArray(std::make_move_iterator(first), std::make_move_iterator(last)) moves elements
+	template <typename TIterator, typename = typename std::iterator_traits<TIterator>::iterator_category>
+	BasicArray(TIterator first, TIterator last)
+		: BasicArray(Uninitialized{}, static_cast<size_t>(std::distance(first, last)),
+			[first](T* target, size_t size) { copy_construct(first, size, target); })
+	{
+		ArrayTracing::trace(EventLog::EventType::Construct, this, "Array(first, last)");
+	}
+
+	// evaluates a whole expression in a single pass - one allocation, no temporaries
+	template <typename TExpression, typename = std::enable_if_t<IsArrayExpression_v<TExpression>>>
+	BasicArray(const TExpression& expr)
+		: BasicArray(Uninitialized{}, expr.size(), [&expr](T* target, size_t) { construct_from(expr, target); })
+	{
+		ArrayTracing::trace(EventLog::EventType::Construct, this, "Array(expression)");
+	}
+
+	// copy constructor
+	BasicArray(const BasicArray& source)
+		: BasicArray(Uninitialized{}, source.size_, [&source](T* target, size_t size) { copy_construct(source.data_, size, target); })
+	{
+		ArrayTracing::trace(EventLog::EventType::CopyConstruct, this, "Array(const Array& - copy constructor)");
+	}
+
+	// copy assignment operator
+	BasicArray& operator=(const BasicArray& source)
+	{
+		if (this != &source) // protection from self-assignment
+		{
+			if (size_ == source.size_)
+			{
+				std::copy_n(source.data_, size_, data_); // reuse storage - memmove for trivially copyable T
+			}
+			else
+			{
+				// copy first - *this stays untouched if copying throws
+				T* data = allocate(source.size_);
+				try
+				{
+					copy_construct(source.data_, source.size_, data);
+				}
+				catch (...)
+				{
+					deallocate(data, source.size_);
+					throw;
+				}
+
+				destroy(data_, size_); // free memory
+				deallocate(data_, size_);
+
+				size_ = source.size_;
+				data_ = data;
+			}
+		}
+
+		ArrayTracing::trace(EventLog::EventType::CopyAssign, this, "Array operator=(const Array& - copy assignment)");
+		return *this;
+	}
+
+	BasicArray(BasicArray&& source) noexcept : size_{source.size_}, data_{source.data_} // transfer of state
+	{
+		// set to resourceless state
+		source.size_ = 0; // optional
+		source.data_ = nullptr; // mandatory
+
+		ArrayTracing::trace(EventLog::EventType::MoveConstruct, this, "Array(Array&& - move constructor)");
+	}
+
+	BasicArray& operator=(BasicArray&& source) noexcept
+	{
+		if (this != &source) // a = std::move(a) - self assignment protection
+		{
+			destroy(data_, size_);
+			deallocate(data_, size_);
+
+			size_ = source.size_;
+			data_ = source.data_;
+
+			source.size_ = 0; // optional
+			source.data_ = nullptr; // mandatory
+		}
+		ArrayTracing::trace(EventLog::EventType::MoveAssign, this, "Array operator=(Array&& - move assignment)");
+
+		return *this;
+	}
+
+	// element-wise expressions read index i only before writing index i, so evaluation in place
+	// is safe even if *this appears in the expression; a new buffer is needed only when size changes
+	template <typename TExpression, typename = std::enable_if_t<IsArrayExpression_v<TExpression>>>
+	BasicArray& operator=(const TExpression& expr)
+	{
+		if (expr.size() == size_)
+		{
+			const size_t size = expr.size();
+			for (size_t i = 0; i < size; ++i)
+				data_[i] = expr[i];
+		}
+		else
+		{
+			T* data = allocate(expr.size());
+			try
+			{
+				construct_from(expr, data);
+			}
+			catch (...)
+			{
+				deallocate(data, expr.size());
+				throw;
+			}
+
+			destroy(data_, size_);
+			deallocate(data_, size_);
+			size_ = expr.size();
+			data_ = data;
+		}
+
+		ArrayTracing::trace(EventLog::EventType::Assign, this, "Array operator=(expression)");
+		return *this;
+	}
+
+	// destructor
+	~BasicArray() noexcept
+	{
+		ArrayTracing::trace(EventLog::EventType::Destroy, this, "~Array()");
+		destroy(data_, size_);
+		deallocate(data_, size_);
+	}
+
+	iterator begin()
+	{
+		return data_;
+	}
+
+	const_iterator begin() const
+	{
+		return data_;
+	}
+
+	iterator end()
+	{
+		return data_ + size_;
+	}
+
+	const_iterator end() const
+	{
+		return data_ + size_;
+	}
+
+	void reset(const T& value)
+	{
+		std::fill_n(data_, size_, value);
+	}
+
+	size_t size() const
+	{
+		return this->size_;
+	}
+
+	T* data()
+	{
+		return data_;
+	}
+
+	const T* data() const
+	{
+		return data_;
+	}
+
+	T& operator[](size_t index)
+	{
+		return data_[index];
+	}
+
+	const T& operator[](size_t index) const
+	{
+		return data_[index];
+	}
+
+private:
+	static T* allocate(size_t size)
+	{
+		return TStorage::template allocate<T>(size);
+	}
+
+	static void deallocate(T* data, size_t size) noexcept
+	{
+		if (data != nullptr)
+			TStorage::deallocate(data, size);
+	}
+
+	static void destroy(T* data, size_t size) noexcept
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>)
+			std::destroy_n(data, size);
+	}
+
+	// uninitialized_copy_n cleans up already constructed elements if a copy throws
+	template <typename TIterator>
+	static void copy_construct(TIterator first, size_t size, T* target)
+	{
+		if constexpr (std::is_trivially_copyable_v<T> && std::is_pointer_v<TIterator>
+			&& std::is_same_v<std::remove_cv_t<std::remove_pointer_t<TIterator>>, T>)
+		{
+			if (size != 0)
+				std::memcpy(target, first, size * sizeof(T));
+		}
+		else
+		{
+			std::uninitialized_copy_n(first, size, target);
+		}
+	}
+
+	template <typename TExpression>
+	static void construct_from(const TExpression& expr, T* target)
+	{
+		const size_t size = expr.size();
+
+		if constexpr (std::is_nothrow_constructible_v<T, decltype(expr[0])>)
+		{
+			for (size_t i = 0; i < size; ++i)
+				::new (static_cast<void*>(target + i)) T(expr[i]);
+		}
+		else
+		{
+			size_t i = 0;
+			try
+			{
+				for (; i < size; ++i)
+					::new (static_cast<void*>(target + i)) T(expr[i]);
+			}
+			catch (...)
+			{
+				destroy(target, i);
+				throw;
+			}
+		}
+	}
+};
+
+template <typename T>
+struct IsBasicArray : std::false_type
+{
+};
+
+template <typename T, typename TStorage>
+struct IsBasicArray<BasicArray<T, TStorage>> : std::true_type
+{
+};
+
+template <typename T>
+constexpr bool IsBasicArray_v = IsBasicArray<T>::value;
+
+using Array = BasicArray<int>;
+
+template <typename T, typename TStorageL, typename TStorageR>
+bool operator==(const BasicArray<T, TStorageL>& lhs, const BasicArray<T, TStorageR>& rhs)
+{
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+#endif /*ARRAY_HPP_*/
@@ -0,0 +1,132 @@
+#ifndef ARRAY_EXPR_HPP_
+#define ARRAY_EXPR_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "array.hpp"
+
+// Lazy arithmetic on Array: a + b * c builds a tree of lightweight nodes,
+// the tree is evaluated element by element when assigned to an Array (one loop, no temporaries)
+//
+// Expressions refer to Array operands by reference - do not keep them alive longer than
+// the arrays (auto e = a + b; is fine only while a & b live)
+
+template <typename T>
+class ScalarOperand
+{
+    T value_;
+
+public:
+    explicit ScalarOperand(T value) : value_{ value }
+    {}
+
+    T operator[](size_t) const
+    {
+        return value_;
+    }
+};
+
+template <typename T>
+struct IsScalarOperand : std::false_type
+{
+};
+
+template <typename T>
+struct IsScalarOperand<ScalarOperand<T>> : std::true_type
+{
+};
+
+template <typename T>
+constexpr bool IsArrayOperand_v = IsBasicArray_v<T> || IsArrayExpression_v<T>;
+
+// Arrays are held by reference, expression nodes & scalars by value
+template <typename T>
+using OperandStorage_t = std::conditional_t<IsBasicArray_v<T>, const T&, T>;
+
+template <typename TOperation, typename TLeft, typename TRight>
+class BinaryExpression
+{
+    OperandStorage_t<TLeft> lhs_;
+    OperandStorage_t<TRight> rhs_;
+
+public:
+    BinaryExpression(const TLeft& lhs, const TRight& rhs) : lhs_{ lhs }, rhs_{ rhs }
+    {
+        if constexpr (!IsScalarOperand<TLeft>::value && !IsScalarOperand<TRight>::value)
+            assert(lhs.size() == rhs.size());
+    }
+
+    auto operator[](size_t index) const
+    {
+        return TOperation{}(lhs_[index], rhs_[index]);
+    }
+
+    size_t size() const
+    {
+        if constexpr (IsScalarOperand<TLeft>::value)
+            return rhs_.size();
+        else
+            return lhs_.size();
+    }
+};
+
+template <typename TOperation, typename TLeft, typename TRight>
+struct IsArrayExpression<BinaryExpression<TOperation, TLeft, TRight>> : std::true_type
+{
+};
+
+namespace ExprDetail
+{
+    template <typename T>
+    decltype(auto) as_operand(const T& value)
+    {
+        if constexpr (std::is_arithmetic_v<T>)
+            return ScalarOperand<T>{ value };
+        else
+            return value;
+    }
+
+    template <typename T>
+    using Operand_t = std::conditional_t<std::is_arithmetic_v<T>, ScalarOperand<T>, T>;
+
+    // at least one side is an Array or an expression, the other may be a scalar
+    template <typename TLeft, typename TRight>
+    constexpr bool IsValidExpression_v =
+        (IsArrayOperand_v<TLeft> && (IsArrayOperand_v<TRight> || std::is_arithmetic_v<TRight>))
+        || (std::is_arithmetic_v<TLeft> && IsArrayOperand_v<TRight>);
+
+    template <typename TOperation, typename TLeft, typename TRight>
+    auto make_expression(const TLeft& lhs, const TRight& rhs)
+    {
+        return BinaryExpression<TOperation, Operand_t<TLeft>, Operand_t<TRight>>(as_operand(lhs), as_operand(rhs));
+    }
+}
+
+template <typename TLeft, typename TRight, typename = std::enable_if_t<ExprDetail::IsValidExpression_v<TLeft, TRight>>>
+auto operator+(const TLeft& lhs, const TRight& rhs)
+{
+    return ExprDetail::make_expression<std::plus<>>(lhs, rhs);
+}
+
+template <typename TLeft, typename TRight, typename = std::enable_if_t<ExprDetail::IsValidExpression_v<TLeft, TRight>>>
+auto operator-(const TLeft& lhs, const TRight& rhs)
+{
+    return ExprDetail::make_expression<std::minus<>>(lhs, rhs);
+}
+
+template <typename TLeft, typename TRight, typename = std::enable_if_t<ExprDetail::IsValidExpression_v<TLeft, TRight>>>
+auto operator*(const TLeft& lhs, const TRight& rhs)
+{
+    return ExprDetail::make_expression<std::multiplies<>>(lhs, rhs);
+}
+
+template <typename TLeft, typename TRight, typename = std::enable_if_t<ExprDetail::IsValidExpression_v<TLeft, TRight>>>
+auto operator/(const TLeft& lhs, const TRight& rhs)
+{
+    return ExprDetail::make_expression<std::divides<>>(lhs, rhs);
+}
+
+#endif /*ARRAY_EXPR_HPP_*/
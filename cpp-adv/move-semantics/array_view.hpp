@@ -0,0 +1,168 @@
+#ifndef ARRAY_VIEW_HPP_
+#define ARRAY_VIEW_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Random access iterator over every stride-th element
+// keeps an index instead of a moving pointer - no out of range pointers for the end of a strided view
+template <typename T>
+class StridedIterator
+{
+    T* base_ = nullptr;
+    ptrdiff_t stride_ = 1;
+    ptrdiff_t index_ = 0;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    StridedIterator() = default;
+
+    StridedIterator(T* base, ptrdiff_t stride, ptrdiff_t index) : base_{ base }, stride_{ stride }, index_{ index }
+    {}
+
+    reference operator*() const { return base_[index_ * stride_]; }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return base_[(index_ + n) * stride_]; }
+
+    StridedIterator& operator++() { ++index_; return *this; }
+    StridedIterator operator++(int) { auto it = *this; ++index_; return it; }
+    StridedIterator& operator--() { --index_; return *this; }
+    StridedIterator operator--(int) { auto it = *this; --index_; return it; }
+
+    StridedIterator& operator+=(difference_type n) { index_ += n; return *this; }
+    StridedIterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+    friend StridedIterator operator+(StridedIterator it, difference_type n) { return it += n; }
+    friend StridedIterator operator+(difference_type n, StridedIterator it) { return it += n; }
+    friend StridedIterator operator-(StridedIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const StridedIterator& lhs, const StridedIterator& rhs) { return lhs.index_ - rhs.index_; }
+
+    friend bool operator==(const StridedIterator& lhs, const StridedIterator& rhs) { return lhs.index_ == rhs.index_; }
+    friend bool operator!=(const StridedIterator& lhs, const StridedIterator& rhs) { return lhs.index_ != rhs.index_; }
+    friend bool operator<(const StridedIterator& lhs, const StridedIterator& rhs) { return lhs.index_ < rhs.index_; }
+    friend bool operator>(const StridedIterator& lhs, const StridedIterator& rhs) { return lhs.index_ > rhs.index_; }
+    friend bool operator<=(const StridedIterator& lhs, const StridedIterator& rhs) { return lhs.index_ <= rhs.index_; }
+    friend bool operator>=(const StridedIterator& lhs, const StridedIterator& rhs) { return lhs.index_ >= rhs.index_; }
+};
+
+// Non-owning view of (optionally strided) elements - copying a view never copies elements
+// ArrayView<int> allows modification, ArrayView<const int> is read-only
+template <typename T>
+class ArrayView
+{
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    ptrdiff_t stride_ = 1;
+
+    template <typename TContainer>
+    using ContainerElement_t = std::remove_pointer_t<decltype(std::data(std::declval<TContainer&>()))>;
+
+public:
+    using value_type = std::remove_cv_t<T>;
+    using iterator = StridedIterator<T>;
+    using const_iterator = iterator; // view is shallow - constness of elements is given by T
+
+    ArrayView() = default;
+
+    ArrayView(T* data, size_t size, ptrdiff_t stride = 1) : data_{ data }, size_{ size }, stride_{ stride }
+    {}
+
+    // Array, Row, std::vector<int>, built-in arrays...
+    template <typename TContainer,
+        typename = std::enable_if_t<!std::is_base_of_v<ArrayView, std::remove_cv_t<TContainer>>
+            && std::is_convertible_v<ContainerElement_t<TContainer>(*)[], T(*)[]>>>
+    ArrayView(TContainer& container) : data_{ std::data(container) }, size_{ std::size(container) }
+    {}
+
+    // ArrayView<int> -> ArrayView<const int>
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    ArrayView(const ArrayView<U>& other) : data_{ other.data() }, size_{ other.size() }, stride_{ other.stride() }
+    {}
+
+    T* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    ptrdiff_t stride() const
+    {
+        return stride_;
+    }
+
+    bool is_contiguous() const
+    {
+        return stride_ == 1;
+    }
+
+    T& operator[](size_t index) const
+    {
+        assert(index < size_);
+        return data_[static_cast<ptrdiff_t>(index) * stride_];
+    }
+
+    iterator begin() const
+    {
+        return iterator(data_, stride_, 0);
+    }
+
+    iterator end() const
+    {
+        return iterator(data_, stride_, static_cast<ptrdiff_t>(size_));
+    }
+
+    // elements [first, first + count)
+    ArrayView subview(size_t first, size_t count) const
+    {
+        assert(first + count <= size_);
+        return ArrayView(data_ + static_cast<ptrdiff_t>(first) * stride_, count, stride_);
+    }
+
+    // every step-th element starting from first: view.slice(1, 3, 2) -> [1], [3], [5]
+    ArrayView slice(size_t first, size_t count, size_t step = 1) const
+    {
+        assert(count == 0 || first + (count - 1) * step < size_);
+        return ArrayView(data_ + static_cast<ptrdiff_t>(first) * stride_, count, stride_ * static_cast<ptrdiff_t>(step));
+    }
+
+    template <typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+    void reset(const value_type& value) const
+    {
+        if (is_contiguous())
+            std::fill_n(data_, size_, value);
+        else
+            std::fill(begin(), end(), value);
+    }
+
+    friend bool operator==(const ArrayView& lhs, const ArrayView& rhs)
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend bool operator!=(const ArrayView& lhs, const ArrayView& rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+template <typename TContainer>
+ArrayView(TContainer&) -> ArrayView<std::remove_pointer_t<decltype(std::data(std::declval<TContainer&>()))>>;
+
+#endif /*ARRAY_VIEW_HPP_*/
@@ -0,0 +1,163 @@
+#ifndef CHROME_TRACE_HPP_
+#define CHROME_TRACE_HPP_
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "event_log.hpp"
+
+// EventLog sink writing Chrome trace-event JSON - open the file in chrome://tracing or ui.perfetto.dev
+// - every event is an instant event on the timeline of its thread:
+//   name = trace point label (e.g. "Array(const Array& - copy constructor)"), cat = event type ("copy", "move", ...),
+//   args.address = object address (follow one object through copies & moves)
+// - filtering by category "copy" shows where deep copies happen
+// Events are written as they are drained - memory use does not grow with the length of the run.
+namespace EventLog
+{
+	class ChromeTrace
+	{
+		std::ostream& out_;
+		std::string line_;
+		std::unordered_set<uint32_t> named_threads_;
+		bool first_ = true;
+		bool finished_ = false;
+
+		template <typename T>
+		void append_number(T value, int base = 10)
+		{
+			char buffer[24];
+			line_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value, base).ptr);
+		}
+
+		void append_string(std::string_view text)
+		{
+			line_ += '"';
+			for (const char c : text)
+			{
+				if (c == '"' || c == '\\')
+				{
+					line_ += '\\';
+					line_ += c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20)
+				{
+					line_ += "\\u00";
+					line_ += "0123456789abcdef"[(c >> 4) & 0xf];
+					line_ += "0123456789abcdef"[c & 0xf];
+				}
+				else
+					line_ += c;
+			}
+			line_ += '"';
+		}
+
+		void begin_event()
+		{
+			line_ += first_ ? "\n" : ",\n";
+			first_ = false;
+		}
+
+		void write_line()
+		{
+			out_.write(line_.data(), static_cast<std::streamsize>(line_.size()));
+			line_.clear();
+		}
+
+	public:
+		explicit ChromeTrace(std::ostream& out) : out_{ out }
+		{
+			out_ << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		}
+
+		ChromeTrace(const ChromeTrace&) = delete;
+		ChromeTrace& operator=(const ChromeTrace&) = delete;
+
+		~ChromeTrace()
+		{
+			finish();
+		}
+
+		void add(uint32_t thread_id, const Event& event)
+		{
+			if (named_threads_.insert(thread_id).second)
+			{
+				begin_event();
+				line_ += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":";
+				append_number(thread_id);
+				line_ += ",\"args\":{\"name\":\"thread ";
+				append_number(thread_id);
+				line_ += "\"}}";
+			}
+
+			begin_event();
+			line_ += "{\"ph\":\"i\",\"s\":\"t\",\"name\":";
+			append_string(event.label != nullptr ? event.label : event_name(event.type));
+			line_ += ",\"cat\":";
+			append_string(event_name(event.type));
+			line_ += ",\"ts\":"; // microseconds
+			append_number(event.timestamp / 1000);
+			line_ += '.';
+			const auto ns = static_cast<unsigned>(event.timestamp % 1000);
+			line_ += static_cast<char>('0' + ns / 100);
+			line_ += static_cast<char>('0' + ns / 10 % 10);
+			line_ += static_cast<char>('0' + ns % 10);
+			line_ += ",\"pid\":1,\"tid\":";
+			append_number(thread_id);
+			line_ += ",\"args\":{\"address\":\"0x";
+			append_number(reinterpret_cast<uintptr_t>(event.address), 16);
+			line_ += "\"}}";
+
+			write_line();
+		}
+
+		// events are passed to add() on the drainer thread - the trace must outlive the recording
+		Sink sink()
+		{
+			return [this](uint32_t thread_id, const Event& event) { add(thread_id, event); };
+		}
+
+		// closes the JSON document - called by the destructor
+		void finish()
+		{
+			if (!finished_)
+			{
+				finished_ = true;
+				out_ << "\n]}\n";
+				out_.flush();
+			}
+		}
+	};
+
+	// records all traced events into a Chrome trace file while in scope
+	class ChromeTraceFile
+	{
+		std::ofstream file_;
+		ChromeTrace trace_;
+
+	public:
+		explicit ChromeTraceFile(const std::string& path) : file_{ path, std::ios::binary }, trace_{ file_ }
+		{
+			if (!file_)
+				throw std::runtime_error("cannot create file: " + path);
+
+			logger().start(trace_.sink());
+		}
+
+		ChromeTraceFile(const ChromeTraceFile&) = delete;
+		ChromeTraceFile& operator=(const ChromeTraceFile&) = delete;
+
+		~ChromeTraceFile()
+		{
+			logger().stop();
+			trace_.finish();
+		}
+	};
+}
+
+#endif /*CHROME_TRACE_HPP_*/
@@ -0,0 +1,353 @@
+#ifndef COMPRESSED_DATASET_HPP_
+#define COMPRESSED_DATASET_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "array_view.hpp"
+#include "dataset.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMPRESSED_DATASET_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Read-only DataSet with bit-packed rows
+// - every row is encoded on its own, either as:
+//   * frame of reference: v[i] = reference + u[i]
+//   * delta:              v[i] = v[i - 4] + reference + u[i]  (v[0..3] are stored verbatim in front of the packed u[i])
+//   whichever needs fewer bits per value; u[i] are packed with the smallest bit width that fits
+// - values are interleaved over 4 lanes (value i goes to lane i % 4) & every lane is packed on its own,
+//   so 4 values share the same bit offset & are decoded at once with SSE2 shifts
+//   (delta is taken over a distance of 4 for the same reason - the prefix sum is a vector add)
+// - per-row metadata is 16 bytes (RowHeader + word offset), so short rows still compress
+// - rows are decoded on scan into a reused buffer (for_each) - no per-row allocation
+// Packed values are limited to 2^32 words (16 GiB) - offsets are 32 bit.
+class CompressedDataSet
+{
+public:
+	enum class Encoding : uint8_t
+	{
+		FrameOfReference,
+		Delta
+	};
+
+private:
+	static constexpr size_t lanes = 4;
+
+	struct RowHeader
+	{
+		uint32_t count;
+		uint32_t reference; // bit pattern of (int32) reference / min delta - decoding wraps modulo 2^32
+		uint8_t bits;
+		Encoding encoding;
+	};
+
+	static_assert(sizeof(RowHeader) == 12);
+
+	std::vector<RowHeader> headers_;
+	std::vector<uint32_t> row_offsets_{ 0 }; // words of row i are packed_[row_offsets_[i], row_offsets_[i + 1])
+	std::vector<uint32_t> packed_;
+	size_t value_count_ = 0;
+
+	static uint8_t bits_needed(uint64_t range)
+	{
+		uint8_t bits = 0;
+		while (range != 0)
+		{
+			++bits;
+			range >>= 1;
+		}
+		return bits;
+	}
+
+	static uint32_t mask(uint8_t bits)
+	{
+		return bits == 32 ? ~uint32_t{ 0 } : (uint32_t{ 1 } << bits) - 1;
+	}
+
+	static size_t packed_size(size_t count, uint8_t bits)
+	{
+		const size_t groups = (count + lanes - 1) / lanes;
+		return (groups * bits + 31) / 32 * lanes;
+	}
+
+	static void pack(uint32_t* words, const uint32_t* offsets, size_t count, uint8_t bits)
+	{
+		if (bits == 0) // all offsets are 0 - nothing to store
+			return;
+
+		std::fill_n(words, packed_size(count, bits), 0u);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t lane = i % lanes;
+			const size_t bit_pos = (i / lanes) * bits;
+			const size_t word = bit_pos / 32;
+			const size_t shift = bit_pos % 32;
+
+			words[word * lanes + lane] |= offsets[i] << shift;
+			if (shift + bits > 32)
+				words[(word + 1) * lanes + lane] |= offsets[i] >> (32 - shift);
+		}
+	}
+
+public:
+	CompressedDataSet() = default;
+
+	explicit CompressedDataSet(const DataSet& ds)
+	{
+		headers_.reserve(ds.rows.size());
+		row_offsets_.reserve(ds.rows.size() + 1);
+		for (const auto& row : ds.rows)
+			add(row.data(), row.size());
+		shrink_to_fit();
+	}
+
+	void add(const int* values, size_t count)
+	{
+		if (count > std::numeric_limits<uint32_t>::max())
+			throw std::length_error("CompressedDataSet: row of more than 2^32 values");
+
+		RowHeader header{ static_cast<uint32_t>(count), 0, 0, Encoding::FrameOfReference };
+		std::vector<uint32_t> offsets(count);
+		size_t verbatim = 0; // delta - v[0..3] are stored as they are
+
+		if (count != 0)
+		{
+			const auto [min, max] = std::minmax_element(values, values + count);
+			const uint8_t for_bits = bits_needed(static_cast<uint64_t>(int64_t{ *max } - *min));
+
+			// deltas over a distance of 4 - differences of two ints need 64-bit arithmetic
+			int64_t min_delta = 0, max_delta = 0;
+			for (size_t i = lanes; i < count; ++i)
+			{
+				const int64_t delta = int64_t{ values[i] } - values[i - lanes];
+				min_delta = i == lanes ? delta : std::min(min_delta, delta);
+				max_delta = i == lanes ? delta : std::max(max_delta, delta);
+			}
+			const uint64_t delta_range = static_cast<uint64_t>(max_delta - min_delta);
+			const uint8_t delta_bits = delta_range >> 32 != 0 ? 64 : bits_needed(delta_range);
+
+			if (count > lanes && delta_bits < for_bits)
+			{
+				header.encoding = Encoding::Delta;
+				header.bits = delta_bits;
+				header.reference = static_cast<uint32_t>(min_delta);
+				verbatim = lanes;
+				for (size_t i = 0; i < lanes; ++i)
+					offsets[i] = static_cast<uint32_t>(values[i]);
+				for (size_t i = lanes; i < count; ++i)
+					offsets[i] = static_cast<uint32_t>(int64_t{ values[i] } - values[i - lanes] - min_delta);
+			}
+			else
+			{
+				header.bits = for_bits;
+				header.reference = static_cast<uint32_t>(*min);
+				for (size_t i = 0; i < count; ++i)
+					offsets[i] = static_cast<uint32_t>(int64_t{ values[i] } - *min);
+			}
+		}
+
+		const size_t first_word = packed_.size();
+		const size_t words = verbatim + packed_size(count - verbatim, header.bits);
+		if (words > std::numeric_limits<uint32_t>::max() - first_word)
+			throw std::length_error("CompressedDataSet: more than 2^32 packed words");
+
+		packed_.resize(first_word + words);
+		std::copy_n(offsets.data(), verbatim, packed_.data() + first_word);
+		pack(packed_.data() + first_word + verbatim, offsets.data() + verbatim, count - verbatim, header.bits);
+
+		headers_.push_back(header);
+		row_offsets_.push_back(static_cast<uint32_t>(packed_.size()));
+		value_count_ += count;
+	}
+
+	template <typename TRow>
+	void add(const TRow& row)
+	{
+		add(std::data(row), std::size(row));
+	}
+
+	size_t size() const
+	{
+		return headers_.size();
+	}
+
+	size_t row_size(size_t index) const
+	{
+		return headers_[index].count;
+	}
+
+	Encoding encoding(size_t index) const
+	{
+		return headers_[index].encoding;
+	}
+
+	unsigned bit_width(size_t index) const
+	{
+		return headers_[index].bits;
+	}
+
+	size_t value_count() const
+	{
+		return value_count_;
+	}
+
+	void shrink_to_fit()
+	{
+		headers_.shrink_to_fit();
+		row_offsets_.shrink_to_fit();
+		packed_.shrink_to_fit();
+	}
+
+	// bytes of packed values & per-row metadata
+	size_t memory_usage() const
+	{
+		return packed_.capacity() * sizeof(uint32_t) + headers_.capacity() * sizeof(RowHeader)
+			+ row_offsets_.capacity() * sizeof(uint32_t);
+	}
+
+	// writes row_size(index) values to out
+	void decode(size_t index, int* out) const
+	{
+		assert(index < headers_.size());
+
+		const RowHeader& header = headers_[index];
+		const uint32_t* words = packed_.data() + row_offsets_[index];
+		size_t count = header.count;
+		const uint32_t value_mask = mask(header.bits);
+		const bool delta = header.encoding == Encoding::Delta;
+
+#ifdef COMPRESSED_DATASET_SSE2
+		const __m128i reference = _mm_set1_epi32(static_cast<int>(header.reference));
+		const __m128i vmask = _mm_set1_epi32(static_cast<int>(value_mask));
+		__m128i previous = _mm_setzero_si128();
+
+		if (delta) // v[0..3] precede the packed values
+		{
+			previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), previous);
+			words += lanes;
+			out += lanes;
+			count -= lanes;
+		}
+
+		const __m128i* packed = reinterpret_cast<const __m128i*>(words);
+		int shift = 0; // bit offset of the current group in *packed - the same for all 4 lanes
+
+		const size_t groups = (count + lanes - 1) / lanes;
+		const size_t full_groups = count / lanes;
+
+		for (size_t group = 0; group < groups; ++group)
+		{
+			__m128i v = reference;
+
+			if (header.bits != 0)
+			{
+				if (shift >= 32)
+				{
+					shift -= 32;
+					++packed;
+				}
+
+				__m128i u = _mm_srl_epi32(_mm_loadu_si128(packed), _mm_cvtsi32_si128(shift));
+				if (shift + header.bits > 32)
+					u = _mm_or_si128(u, _mm_sll_epi32(_mm_loadu_si128(packed + 1), _mm_cvtsi32_si128(32 - shift)));
+				shift += header.bits;
+
+				v = _mm_add_epi32(v, _mm_and_si128(u, vmask));
+			}
+
+			if (delta)
+				previous = v = _mm_add_epi32(v, previous);
+
+			if (group < full_groups)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + group * lanes), v);
+			}
+			else
+			{
+				alignas(16) int tail[lanes];
+				_mm_store_si128(reinterpret_cast<__m128i*>(tail), v);
+				std::copy(tail, tail + (count - group * lanes), out + group * lanes);
+			}
+		}
+#else
+		uint32_t previous[lanes] = {};
+
+		if (delta) // v[0..3] precede the packed values
+		{
+			for (size_t i = 0; i < lanes; ++i)
+				out[i] = static_cast<int>(previous[i] = words[i]);
+			words += lanes;
+			out += lanes;
+			count -= lanes;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t lane = i % lanes;
+			uint32_t v = 0;
+
+			if (header.bits != 0)
+			{
+				const size_t bit_pos = (i / lanes) * header.bits;
+				const size_t word = bit_pos / 32;
+				const size_t shift = bit_pos % 32;
+
+				v = words[word * lanes + lane] >> shift;
+				if (shift + header.bits > 32)
+					v |= words[(word + 1) * lanes + lane] << (32 - shift);
+				v &= value_mask;
+			}
+
+			v += header.reference;
+			if (delta)
+				previous[lane] = v += previous[lane];
+
+			out[i] = static_cast<int>(v);
+		}
+#endif
+	}
+
+	Row operator[](size_t index) const
+	{
+		Row row(row_size(index));
+		decode(index, row.data());
+		return row;
+	}
+
+	// f(index, ArrayView<const int>) for every row - rows are decoded into one reused buffer
+	template <typename TFunction>
+	void for_each(TFunction f) const
+	{
+		std::vector<int> buffer;
+
+		for (size_t i = 0; i < headers_.size(); ++i)
+		{
+			buffer.resize(headers_[i].count);
+			decode(i, buffer.data());
+			f(i, ArrayView<const int>(buffer.data(), buffer.size()));
+		}
+	}
+
+	DataSet to_dataset() const
+	{
+		DataSet ds;
+		ds.rows.reserve(size());
+
+		for (size_t i = 0; i < size(); ++i)
+			ds.rows.push_back((*this)[i]);
+
+		return ds;
+	}
+};
+
+#endif /*COMPRESSED_DATASET_HPP_*/
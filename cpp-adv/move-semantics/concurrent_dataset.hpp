@@ -0,0 +1,95 @@
+#ifndef CONCURRENT_DATASET_HPP_
+#define CONCURRENT_DATASET_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "dataset.hpp"
+
+// DataSet filled by many threads at once
+// - every producing thread gets its own Producer with a private append buffer (segment),
+//   so add() takes no lock and shares no cache lines with other producers
+// - the mutex is taken only when a producer is created
+// - collect() moves rows out of all segments into one DataSet (rows are moved, elements are not copied)
+// size(), for_each() & collect() must not run concurrently with add()
+class ConcurrentDataSet
+{
+	struct alignas(64) Segment
+	{
+		std::vector<Row> rows;
+	};
+
+	std::mutex mtx_;
+	std::deque<Segment> segments_; // emplace_back does not invalidate references to segments
+
+public:
+	class Producer
+	{
+		Segment* segment_;
+
+		friend class ConcurrentDataSet;
+
+		explicit Producer(Segment& segment) : segment_{ &segment }
+		{
+		}
+
+	public:
+		template <typename TRow>
+		void add(TRow&& r)
+		{
+			segment_->rows.emplace_back(std::forward<TRow>(r));
+		}
+
+		void reserve(size_t count)
+		{
+			segment_->rows.reserve(count);
+		}
+	};
+
+	ConcurrentDataSet() = default;
+	ConcurrentDataSet(const ConcurrentDataSet&) = delete;
+	ConcurrentDataSet& operator=(const ConcurrentDataSet&) = delete;
+
+	// one producer per thread - a Producer must not be shared between threads
+	Producer producer()
+	{
+		std::lock_guard lk{ mtx_ };
+		return Producer{ segments_.emplace_back() };
+	}
+
+	size_t size() const
+	{
+		size_t total = 0;
+		for (const auto& segment : segments_)
+			total += segment.rows.size();
+		return total;
+	}
+
+	template <typename TFunction>
+	void for_each(TFunction f) const
+	{
+		for (const auto& segment : segments_)
+			for (const auto& row : segment.rows)
+				f(row);
+	}
+
+	DataSet collect()
+	{
+		DataSet ds;
+		ds.rows.reserve(size());
+
+		for (auto& segment : segments_)
+		{
+			std::move(segment.rows.begin(), segment.rows.end(), std::back_inserter(ds.rows));
+			segment.rows.clear();
+		}
+
+		return ds;
+	}
+};
+
+#endif /*CONCURRENT_DATASET_HPP_*/
@@ -0,0 +1,245 @@
+#ifndef CSV_LOADER_HPP_
+#define CSV_LOADER_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "dataset.hpp"
+
+// Streaming loader of delimited integer text into a DataSet
+// - input is read in large chunks; a line cut by the end of a chunk is carried over to the next one
+// - integers are parsed with std::from_chars straight from the chunk buffer (no iostreams, no locale)
+// - values of a line are collected in a reused buffer and copied once into the row (one allocation per row)
+// - with threads > 1 every chunk is split at line boundaries & parsed in parallel, rows keep the input order
+// Blank lines are skipped; spaces, tabs & '\r' around values are ignored.
+namespace Csv
+{
+	struct Options
+	{
+		char delimiter = ',';
+		size_t chunk_size = 4 * 1024 * 1024;
+		size_t threads = 1;
+	};
+
+	namespace Detail
+	{
+		struct ParseError
+		{
+			const char* position;
+		};
+
+		inline const char* skip_blanks(const char* first, const char* last)
+		{
+			while (first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+				++first;
+			return first;
+		}
+
+		inline const char* find_newline(const char* first, const char* last)
+		{
+			// memchr is vectorized by the C runtime
+			const void* pos = std::memchr(first, '\n', static_cast<size_t>(last - first));
+			return pos != nullptr ? static_cast<const char*>(pos) : last;
+		}
+
+		inline const char* find_last_newline(const char* first, const char* last)
+		{
+			for (const char* it = last; it != first; --it)
+			{
+				if (*(it - 1) == '\n')
+					return it - 1;
+			}
+			return nullptr;
+		}
+
+		// values of one line [first, eol) - false for a blank line
+		inline bool parse_line(const char* first, const char* eol, char delimiter, std::vector<int>& values)
+		{
+			const char* pos = skip_blanks(first, eol);
+			if (pos == eol)
+				return false;
+
+			values.clear();
+
+			while (true)
+			{
+				int value;
+				auto [end, error] = std::from_chars(pos, eol, value);
+				if (error != std::errc{})
+					throw ParseError{ pos };
+
+				values.push_back(value);
+
+				pos = skip_blanks(end, eol);
+				if (pos == eol)
+					return true;
+				if (*pos != delimiter)
+					throw ParseError{ pos };
+
+				pos = skip_blanks(pos + 1, eol);
+			}
+		}
+
+		inline void parse_lines(const char* first, const char* last, char delimiter, std::vector<Row>& rows, std::vector<int>& values)
+		{
+			for (const char* line = first; line != last; )
+			{
+				const char* eol = find_newline(line, last);
+
+				if (parse_line(line, eol, delimiter, values))
+					rows.emplace_back(values.data(), values.data() + values.size());
+
+				line = (eol == last) ? last : eol + 1;
+			}
+		}
+
+		inline void parse_chunk(const char* first, const char* last, const Options& options, std::vector<Row>& rows, std::vector<int>& values)
+		{
+			if (options.threads <= 1)
+			{
+				parse_lines(first, last, options.delimiter, rows, values);
+				return;
+			}
+
+			// split at line boundaries - every part starts right after '\n'
+			std::vector<const char*> bounds{ first };
+			const size_t part_size = static_cast<size_t>(last - first) / options.threads;
+			for (size_t i = 1; i < options.threads; ++i)
+			{
+				const char* split = std::max(bounds.back(), first + i * part_size);
+				const char* eol = find_newline(split, last);
+				bounds.push_back(eol == last ? last : eol + 1);
+			}
+			bounds.push_back(last);
+
+			std::vector<std::future<std::vector<Row>>> parts;
+			for (size_t i = 1; i + 1 < bounds.size(); ++i)
+			{
+				parts.push_back(std::async(std::launch::async, [&options, first = bounds[i], last = bounds[i + 1]] {
+					std::vector<Row> part_rows;
+					std::vector<int> part_values;
+					parse_lines(first, last, options.delimiter, part_rows, part_values);
+					return part_rows;
+				}));
+			}
+
+			parse_lines(bounds[0], bounds[1], options.delimiter, rows, values);
+
+			for (auto& part : parts)
+			{
+				std::vector<Row> part_rows = part.get();
+				std::move(part_rows.begin(), part_rows.end(), std::back_inserter(rows));
+			}
+		}
+	}
+
+	// input split into blocks of complete lines - a line cut by the end of a chunk is carried over to the next one
+	class ChunkReader
+	{
+		std::istream& in_;
+		std::vector<char> buffer_;
+		size_t filled_ = 0;   // bytes read into the buffer
+		size_t consumed_ = 0; // bytes returned by the last next()
+		uint64_t offset_ = 0; // offset of buffer_[0] in the input - for error messages
+		bool end_ = false;
+
+	public:
+		ChunkReader(std::istream& in, size_t chunk_size) : in_{ in }, buffer_(std::max<size_t>(chunk_size, 1))
+		{
+		}
+
+		// [first, last) - next block of complete lines (the last line of the input may have no '\n')
+		bool next(const char*& first, const char*& last)
+		{
+			if (end_)
+				return false;
+
+			size_t carry = filled_ - consumed_;
+			std::memmove(buffer_.data(), buffer_.data() + consumed_, carry);
+			offset_ += consumed_;
+
+			while (true)
+			{
+				in_.read(buffer_.data() + carry, static_cast<std::streamsize>(buffer_.size() - carry));
+				if (in_.bad())
+					throw std::runtime_error("csv: read error");
+
+				filled_ = carry + static_cast<size_t>(in_.gcount());
+				first = buffer_.data();
+
+				if (in_.eof())
+				{
+					end_ = true;
+					consumed_ = filled_;
+					last = first + filled_;
+					return true;
+				}
+
+				const char* newline = Detail::find_last_newline(first, first + filled_);
+				if (newline == nullptr) // line longer than the buffer
+				{
+					carry = filled_;
+					buffer_.resize(buffer_.size() * 2);
+					continue;
+				}
+
+				last = newline + 1;
+				consumed_ = static_cast<size_t>(last - first);
+				return true;
+			}
+		}
+
+		// position points into the last block returned by next()
+		std::runtime_error parse_error(const char* position) const
+		{
+			return std::runtime_error("csv: invalid value at offset " + std::to_string(offset_ + static_cast<uint64_t>(position - buffer_.data())));
+		}
+	};
+
+	inline void load(std::istream& in, DataSet& ds, const Options& options = {})
+	{
+		ChunkReader reader{ in, options.chunk_size };
+		std::vector<int> values;
+
+		for (const char *first, *last; reader.next(first, last); )
+		{
+			try
+			{
+				Detail::parse_chunk(first, last, options, ds.rows, values);
+			}
+			catch (const Detail::ParseError& e)
+			{
+				throw reader.parse_error(e.position);
+			}
+		}
+	}
+
+	inline DataSet load(std::istream& in, const Options& options = {})
+	{
+		DataSet ds;
+		load(in, ds, options);
+		return ds;
+	}
+
+	inline DataSet load(const std::string& path, const Options& options = {})
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			throw std::runtime_error("cannot open file: " + path);
+
+		return load(in, options);
+	}
+}
+
+#endif /*CSV_LOADER_HPP_*/
@@ -0,0 +1,38 @@
+#ifndef DATASET_HPP_
+#define DATASET_HPP_
+
+#include <utility>
+#include <vector>
+
+#include "array.hpp"
+
+// query.hpp - not included, so DataSet users do not pull in <future> & threads
+namespace QueryDetail
+{
+	struct Identity;
+}
+
+template <typename TRange, typename TStage>
+class Query;
+
+using Row = Array;
+
+struct DataSet
+{
+	std::vector<Row> rows;
+
+	template <typename TRow>
+	void add(TRow&& r)
+	{
+		rows.emplace_back(std::forward<TRow>(r));
+	}
+
+	// lazy, fused filter/map/reduce pipeline over rows - include query.hpp to call it
+	template <typename TQuery = Query<std::vector<Row>, QueryDetail::Identity>>
+	TQuery view() const
+	{
+		return TQuery{ rows };
+	}
+};
+
+#endif /*DATASET_HPP_*/
@@ -0,0 +1,277 @@
+#ifndef DATASET_FILE_HPP_
+#define DATASET_FILE_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "array_view.hpp"
+#include "dataset.hpp"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary DataSet file (native byte order):
+//   FileHeader
+//   uint64_t offsets[row_count + 1]  - row i is payload[offsets[i], offsets[i + 1])
+//   int32_t payload[value_count]
+namespace DataSetFile
+{
+	static_assert(sizeof(int) == sizeof(int32_t), "rows are stored as int32_t");
+
+	constexpr char magic[4] = { 'D', 'S', 'E', 'T' };
+	constexpr uint32_t version = 1;
+
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t row_count;
+		uint64_t value_count;
+	};
+
+	// header, offsets & payload are laid out in one block & written with a single write
+	// (the block is a second copy of the data while saving)
+	inline void save(const DataSet& ds, const std::string& path)
+	{
+		uint64_t value_count = 0;
+		for (const auto& row : ds.rows)
+			value_count += row.size();
+
+		const size_t offsets_size = (ds.rows.size() + 1) * sizeof(uint64_t);
+		std::vector<char> block(sizeof(FileHeader) + offsets_size + static_cast<size_t>(value_count) * sizeof(int));
+
+		const FileHeader header{ { magic[0], magic[1], magic[2], magic[3] }, version, ds.rows.size(), value_count };
+		std::memcpy(block.data(), &header, sizeof(header));
+
+		char* offset = block.data() + sizeof(FileHeader);
+		char* payload = offset + offsets_size;
+		uint64_t value_offset = 0;
+
+		std::memcpy(offset, &value_offset, sizeof(uint64_t));
+		for (const auto& row : ds.rows)
+		{
+			if (row.size() != 0)
+				std::memcpy(payload, row.data(), row.size() * sizeof(int));
+			payload += row.size() * sizeof(int);
+
+			value_offset += row.size();
+			offset += sizeof(uint64_t);
+			std::memcpy(offset, &value_offset, sizeof(uint64_t));
+		}
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw std::runtime_error("cannot create file: " + path);
+
+		if (!out.write(block.data(), static_cast<std::streamsize>(block.size())).flush())
+			throw std::runtime_error("cannot write file: " + path);
+	}
+
+	// read-only memory mapping of a whole file
+	class MappedFile
+	{
+		const std::byte* data_ = nullptr;
+		size_t size_ = 0;
+#if defined(_WIN32)
+		HANDLE mapping_ = nullptr;
+#endif
+
+		void close() noexcept
+		{
+#if defined(_WIN32)
+			if (data_ != nullptr)
+				::UnmapViewOfFile(data_);
+			if (mapping_ != nullptr)
+				::CloseHandle(mapping_);
+			mapping_ = nullptr;
+#else
+			if (data_ != nullptr)
+				::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+			data_ = nullptr;
+			size_ = 0;
+		}
+
+	public:
+		explicit MappedFile(const std::string& path)
+		{
+#if defined(_WIN32)
+			HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				throw std::runtime_error("cannot open file: " + path);
+
+			LARGE_INTEGER file_size;
+			if (!::GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+			{
+				::CloseHandle(file);
+				throw std::runtime_error("cannot map file: " + path);
+			}
+
+			mapping_ = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			::CloseHandle(file); // mapping keeps the file open
+
+			if (mapping_ == nullptr)
+				throw std::runtime_error("cannot map file: " + path);
+
+			data_ = static_cast<const std::byte*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+			if (data_ == nullptr)
+			{
+				close();
+				throw std::runtime_error("cannot map file: " + path);
+			}
+			size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd == -1)
+				throw std::runtime_error("cannot open file: " + path);
+
+			struct stat st;
+			if (::fstat(fd, &st) == -1 || st.st_size == 0)
+			{
+				::close(fd);
+				throw std::runtime_error("cannot map file: " + path);
+			}
+
+			void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd); // mapping keeps the file open
+
+			if (addr == MAP_FAILED)
+				throw std::runtime_error("cannot map file: " + path);
+
+			data_ = static_cast<const std::byte*>(addr);
+			size_ = static_cast<size_t>(st.st_size);
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept
+			: data_{ std::exchange(other.data_, nullptr) }, size_{ std::exchange(other.size_, 0) }
+#if defined(_WIN32)
+			, mapping_{ std::exchange(other.mapping_, nullptr) }
+#endif
+		{
+		}
+
+		MappedFile& operator=(MappedFile&& other) noexcept
+		{
+			if (this != &other)
+			{
+				close();
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+				mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+			}
+
+			return *this;
+		}
+
+		~MappedFile() noexcept
+		{
+			close();
+		}
+
+		const std::byte* data() const
+		{
+			return data_;
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+	};
+}
+
+// Zero-copy, read-only DataSet backed by a mapped file - rows are views into the mapping
+class MappedDataSet
+{
+	DataSetFile::MappedFile file_;
+	const uint64_t* offsets_;
+	const int* payload_;
+	size_t row_count_;
+	uint64_t value_count_;
+
+public:
+	explicit MappedDataSet(const std::string& path) : file_{ path }
+	{
+		using namespace DataSetFile;
+
+		if (file_.size() < sizeof(FileHeader))
+			throw std::runtime_error("not a DataSet file: " + path);
+
+		FileHeader header;
+		std::memcpy(&header, file_.data(), sizeof(header));
+
+		if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version)
+			throw std::runtime_error("not a DataSet file: " + path);
+
+		const uint64_t expected_size = sizeof(FileHeader) + (header.row_count + 1) * sizeof(uint64_t) + header.value_count * sizeof(int);
+		if (header.row_count > file_.size() || header.value_count > file_.size() || expected_size != file_.size())
+			throw std::runtime_error("corrupted DataSet file: " + path);
+
+		offsets_ = reinterpret_cast<const uint64_t*>(file_.data() + sizeof(FileHeader));
+		payload_ = reinterpret_cast<const int*>(offsets_ + header.row_count + 1);
+		row_count_ = static_cast<size_t>(header.row_count);
+		value_count_ = header.value_count;
+
+		if (offsets_[row_count_] != header.value_count)
+			throw std::runtime_error("corrupted DataSet file: " + path);
+	}
+
+	size_t size() const
+	{
+		return row_count_;
+	}
+
+	ArrayView<const int> operator[](size_t index) const
+	{
+		assert(index < row_count_);
+
+		const uint64_t first = offsets_[index];
+		const uint64_t last = offsets_[index + 1];
+		if (first > last || last > value_count_)
+			throw std::runtime_error("corrupted DataSet file - invalid row offsets");
+
+		return ArrayView<const int>(payload_ + first, static_cast<size_t>(last - first));
+	}
+
+	// copies rows into a regular (mutable) DataSet
+	DataSet to_dataset() const
+	{
+		DataSet ds;
+		ds.rows.reserve(row_count_);
+
+		for (size_t i = 0; i < row_count_; ++i)
+		{
+			const auto row = (*this)[i];
+			ds.rows.emplace_back(row.data(), row.data() + row.size());
+		}
+
+		return ds;
+	}
+};
+
+#endif /*DATASET_FILE_HPP_*/
@@ -0,0 +1,269 @@
+#ifndef DATASET_INDEX_HPP_
+#define DATASET_INDEX_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "array_view.hpp"
+#include "dataset.hpp"
+
+// Open addressing (linear probing) hash map with int keys - slots live in one contiguous vector
+template <typename TValue>
+class IntHashMap
+{
+	struct Slot
+	{
+		int key;
+		bool used;
+		TValue value;
+	};
+
+	std::vector<Slot> slots_;
+	size_t size_ = 0;
+
+	static size_t hash(int key)
+	{
+		// Fibonacci hashing - spreads sequential keys over the whole table
+		return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+
+	size_t mask() const
+	{
+		return slots_.size() - 1;
+	}
+
+	void rehash(size_t capacity)
+	{
+		std::vector<Slot> old = std::exchange(slots_, std::vector<Slot>(capacity, Slot{ 0, false, TValue{} }));
+
+		for (auto& slot : old)
+		{
+			if (slot.used)
+			{
+				size_t pos = hash(slot.key) & mask();
+				while (slots_[pos].used)
+					pos = (pos + 1) & mask();
+				slots_[pos] = std::move(slot);
+			}
+		}
+	}
+
+public:
+	explicit IntHashMap(size_t expected_size = 16)
+	{
+		size_t capacity = 16;
+		while (capacity < 2 * expected_size)
+			capacity *= 2;
+		slots_.assign(capacity, Slot{ 0, false, TValue{} });
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	// inserts a value-initialized TValue for a new key; load factor is kept below 1/2
+	TValue& operator[](int key)
+	{
+		size_t pos = hash(key) & mask();
+		while (slots_[pos].used)
+		{
+			if (slots_[pos].key == key)
+				return slots_[pos].value;
+			pos = (pos + 1) & mask();
+		}
+
+		if (2 * (size_ + 1) > slots_.size())
+		{
+			rehash(2 * slots_.size());
+			return (*this)[key];
+		}
+
+		slots_[pos].key = key;
+		slots_[pos].used = true;
+		++size_;
+		return slots_[pos].value;
+	}
+
+	const TValue* find(int key) const
+	{
+		for (size_t pos = hash(key) & mask(); slots_[pos].used; pos = (pos + 1) & mask())
+		{
+			if (slots_[pos].key == key)
+				return &slots_[pos].value;
+		}
+		return nullptr;
+	}
+
+	template <typename TFunction>
+	void for_each(TFunction f)
+	{
+		for (auto& slot : slots_)
+			if (slot.used)
+				f(slot.key, slot.value);
+	}
+
+	template <typename TFunction>
+	void for_each(TFunction f) const
+	{
+		for (const auto& slot : slots_)
+			if (slot.used)
+				f(slot.key, slot.value);
+	}
+};
+
+// Row numbers grouped by the value of one column
+// built in two passes (count, fill) into a single vector of row numbers
+// rows too short to have the column are not indexed; the index is not updated when the DataSet changes
+class HashIndex
+{
+	struct Range
+	{
+		size_t first;
+		size_t count;
+	};
+
+	size_t column_;
+	IntHashMap<Range> ranges_;
+	std::vector<size_t> row_numbers_;
+
+public:
+	HashIndex(const DataSet& ds, size_t column) : column_{ column }
+	{
+		size_t indexed = 0;
+		for (const auto& row : ds.rows)
+		{
+			if (column_ < row.size())
+			{
+				++ranges_[row[column_]].count;
+				++indexed;
+			}
+		}
+
+		size_t first = 0;
+		ranges_.for_each([&first](int, Range& range) {
+			range.first = first;
+			first += range.count;
+			range.count = 0;
+		});
+
+		row_numbers_.resize(indexed);
+		for (size_t i = 0; i < ds.rows.size(); ++i)
+		{
+			if (column_ < ds.rows[i].size())
+			{
+				Range& range = ranges_[ds.rows[i][column_]];
+				row_numbers_[range.first + range.count++] = i;
+			}
+		}
+	}
+
+	size_t column() const
+	{
+		return column_;
+	}
+
+	size_t key_count() const
+	{
+		return ranges_.size();
+	}
+
+	// numbers of rows with row[column()] == key, in increasing order
+	ArrayView<const size_t> find(int key) const
+	{
+		const Range* range = ranges_.find(key);
+		if (range == nullptr)
+			return {};
+
+		return ArrayView<const size_t>(row_numbers_.data() + range->first, range->count);
+	}
+};
+
+struct Aggregate
+{
+	size_t count = 0;
+	int64_t sum = 0;
+	int min = std::numeric_limits<int>::max();
+	int max = std::numeric_limits<int>::min();
+
+	void add(int value)
+	{
+		++count;
+		sum += value;
+		min = std::min(min, value);
+		max = std::max(max, value);
+	}
+
+	void merge(const Aggregate& other)
+	{
+		count += other.count;
+		sum += other.sum;
+		min = std::min(min, other.min);
+		max = std::max(max, other.max);
+	}
+};
+
+namespace IndexDetail
+{
+	inline IntHashMap<Aggregate> aggregate_rows(const DataSet& ds, size_t first, size_t last, size_t key_column, size_t value_column)
+	{
+		IntHashMap<Aggregate> groups;
+
+		for (size_t i = first; i < last; ++i)
+		{
+			const Row& row = ds.rows[i];
+			if (key_column < row.size() && value_column < row.size())
+				groups[row[key_column]].add(row[value_column]);
+		}
+
+		return groups;
+	}
+}
+
+// count, sum, min & max of value_column for every distinct key_column - one pass over the rows
+// with threads > 1 every thread aggregates its own range of rows, partial results are merged at the end
+// rows without key_column or value_column are skipped; result is sorted by key
+inline std::vector<std::pair<int, Aggregate>> group_by(const DataSet& ds, size_t key_column, size_t value_column, size_t threads = 1)
+{
+	IntHashMap<Aggregate> groups;
+
+	if (threads <= 1 || ds.rows.size() < 2 * threads)
+	{
+		groups = IndexDetail::aggregate_rows(ds, 0, ds.rows.size(), key_column, value_column);
+	}
+	else
+	{
+		const size_t chunk = (ds.rows.size() + threads - 1) / threads;
+
+		std::vector<std::future<IntHashMap<Aggregate>>> partials;
+		for (size_t first = chunk; first < ds.rows.size(); first += chunk)
+		{
+			const size_t last = std::min(first + chunk, ds.rows.size());
+			partials.push_back(std::async(std::launch::async, IndexDetail::aggregate_rows, std::cref(ds), first, last, key_column, value_column));
+		}
+
+		groups = IndexDetail::aggregate_rows(ds, 0, chunk, key_column, value_column);
+
+		for (auto& partial : partials)
+		{
+			partial.get().for_each([&groups](int key, const Aggregate& aggregate) {
+				groups[key].merge(aggregate);
+			});
+		}
+	}
+
+	std::vector<std::pair<int, Aggregate>> result;
+	result.reserve(groups.size());
+	groups.for_each([&result](int key, const Aggregate& aggregate) { result.emplace_back(key, aggregate); });
+
+	std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+	return result;
+}
+
+#endif /*DATASET_INDEX_HPP_*/
@@ -0,0 +1,274 @@
+#ifndef DATASET_SORT_HPP_
+#define DATASET_SORT_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "dataset.hpp"
+
+// Sorting of DataSet rows by the value of one column
+// - rows are never moved while sorting: (key, row number) pairs are sorted (LSD radix sort on 32-bit keys)
+//   & rows are moved once at the end - apply_permutation()
+// - all sorts are stable; rows too short to have the column keep their order after all other rows
+enum class SortOrder
+{
+	Ascending,
+	Descending
+};
+
+namespace SortDetail
+{
+	struct SortEntry
+	{
+		uint32_t key; // order preserving image of the int value - unsigned comparison gives the requested order
+		size_t row;
+	};
+
+	inline uint32_t sort_key(int value, SortOrder order)
+	{
+		const uint32_t key = static_cast<uint32_t>(value) ^ 0x8000'0000u; // INT_MIN -> 0, INT_MAX -> 0xFFFF'FFFF
+		return order == SortOrder::Ascending ? key : ~key;
+	}
+
+	inline bool key_less(const SortEntry& lhs, const SortEntry& rhs)
+	{
+		return lhs.key < rhs.key;
+	}
+
+	// rows without the column are appended to missing
+	inline std::vector<SortEntry> sort_entries(const DataSet& ds, size_t column, SortOrder order, std::vector<size_t>& missing)
+	{
+		std::vector<SortEntry> entries;
+		entries.reserve(ds.rows.size());
+
+		for (size_t i = 0; i < ds.rows.size(); ++i)
+		{
+			if (column < ds.rows[i].size())
+				entries.push_back(SortEntry{ sort_key(ds.rows[i][column], order), i });
+			else
+				missing.push_back(i);
+		}
+
+		return entries;
+	}
+
+	// stable LSD radix sort - 4 passes of 8 bits, passes where all keys share the byte are skipped
+	inline void radix_sort(SortEntry* first, SortEntry* last, SortEntry* buffer)
+	{
+		const size_t size = static_cast<size_t>(last - first);
+
+		std::array<std::array<size_t, 256>, 4> counts{};
+		for (const SortEntry* it = first; it != last; ++it)
+			for (size_t pass = 0; pass < 4; ++pass)
+				++counts[pass][(it->key >> (8 * pass)) & 0xFF];
+
+		SortEntry* source = first;
+		SortEntry* target = buffer;
+
+		for (size_t pass = 0; pass < 4; ++pass)
+		{
+			auto& count = counts[pass];
+			if (std::find(count.begin(), count.end(), size) != count.end())
+				continue;
+
+			size_t offset = 0;
+			for (auto& c : count)
+				offset += std::exchange(c, offset);
+
+			for (const SortEntry* it = source; it != source + size; ++it)
+				target[count[(it->key >> (8 * pass)) & 0xFF]++] = *it;
+
+			std::swap(source, target);
+		}
+
+		if (source != first)
+			std::copy(source, source + size, first);
+	}
+
+	inline std::vector<size_t> row_numbers(const std::vector<SortEntry>& entries, const std::vector<size_t>& missing)
+	{
+		std::vector<size_t> order;
+		order.reserve(entries.size() + missing.size());
+
+		for (const auto& entry : entries)
+			order.push_back(entry.row);
+		order.insert(order.end(), missing.begin(), missing.end());
+
+		return order;
+	}
+}
+
+// row numbers in sorted order (argsort)
+inline std::vector<size_t> sort_order(const DataSet& ds, size_t column, SortOrder order = SortOrder::Ascending)
+{
+	std::vector<size_t> missing;
+	std::vector<SortDetail::SortEntry> entries = SortDetail::sort_entries(ds, column, order, missing);
+	std::vector<SortDetail::SortEntry> buffer(entries.size());
+
+	SortDetail::radix_sort(entries.data(), entries.data() + entries.size(), buffer.data());
+
+	return SortDetail::row_numbers(entries, missing);
+}
+
+// parallel merge sort - every thread radix sorts its own part, parts are merged pairwise (also in parallel)
+inline std::vector<size_t> parallel_sort_order(const DataSet& ds, size_t column, size_t threads, SortOrder order = SortOrder::Ascending)
+{
+	std::vector<size_t> missing;
+	std::vector<SortDetail::SortEntry> entries = SortDetail::sort_entries(ds, column, order, missing);
+	std::vector<SortDetail::SortEntry> buffer(entries.size());
+
+	if (threads <= 1 || entries.size() < 2 * threads)
+	{
+		SortDetail::radix_sort(entries.data(), entries.data() + entries.size(), buffer.data());
+		return SortDetail::row_numbers(entries, missing);
+	}
+
+	const size_t chunk = (entries.size() + threads - 1) / threads;
+	std::vector<size_t> bounds;
+	for (size_t first = 0; first < entries.size(); first += chunk)
+		bounds.push_back(first);
+	bounds.push_back(entries.size());
+
+	SortDetail::SortEntry* const data = entries.data();
+	SortDetail::SortEntry* const temp = buffer.data();
+
+	std::vector<std::future<void>> parts;
+	for (size_t i = 1; i + 1 < bounds.size(); ++i)
+		parts.push_back(std::async(std::launch::async, SortDetail::radix_sort, data + bounds[i], data + bounds[i + 1], temp + bounds[i]));
+
+	SortDetail::radix_sort(data, data + bounds[1], temp);
+
+	for (auto& part : parts)
+		part.get();
+
+	// merge rounds: parts [2i, 2i + 1] -> one part; merging the left part first keeps the sort stable
+	SortDetail::SortEntry* source = data;
+	SortDetail::SortEntry* target = temp;
+
+	while (bounds.size() > 2)
+	{
+		std::vector<size_t> merged_bounds;
+		for (size_t i = 0; i < bounds.size() - 1; i += 2)
+			merged_bounds.push_back(bounds[i]);
+		merged_bounds.push_back(bounds.back());
+
+		std::vector<std::future<void>> tasks;
+		for (size_t i = 0; i + 1 < bounds.size(); i += 2)
+		{
+			const size_t first = bounds[i];
+			const size_t middle = bounds[i + 1];
+			const size_t last = i + 2 < bounds.size() ? bounds[i + 2] : middle;
+
+			auto merge = [=] { std::merge(source + first, source + middle, source + middle, source + last, target + first, SortDetail::key_less); };
+
+			if (i + 2 < bounds.size() - 1)
+				tasks.push_back(std::async(std::launch::async, merge));
+			else
+				merge();
+		}
+		for (auto& task : tasks)
+			task.get();
+
+		bounds = std::move(merged_bounds);
+		std::swap(source, target);
+	}
+
+	if (source != data)
+		std::copy(source, source + entries.size(), data);
+
+	return SortDetail::row_numbers(entries, missing);
+}
+
+// row numbers of the k rows with the largest (Descending) or smallest (Ascending) value in column - O(n log k)
+// result is sorted; ties are broken by row number
+inline std::vector<size_t> top_k(const DataSet& ds, size_t column, size_t k, SortOrder order = SortOrder::Descending)
+{
+	auto less = [](const SortDetail::SortEntry& lhs, const SortDetail::SortEntry& rhs) {
+		return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.row < rhs.row);
+	};
+
+	// max-heap of the k best entries seen so far - the worst of them on top
+	std::vector<SortDetail::SortEntry> heap;
+	heap.reserve(std::min(k, ds.rows.size()));
+
+	for (size_t i = 0; i < ds.rows.size() && k != 0; ++i)
+	{
+		if (column >= ds.rows[i].size())
+			continue;
+
+		const SortDetail::SortEntry entry{ SortDetail::sort_key(ds.rows[i][column], order), i };
+
+		if (heap.size() < k)
+		{
+			heap.push_back(entry);
+			std::push_heap(heap.begin(), heap.end(), less);
+		}
+		else if (less(entry, heap.front()))
+		{
+			std::pop_heap(heap.begin(), heap.end(), less);
+			heap.back() = entry;
+			std::push_heap(heap.begin(), heap.end(), less);
+		}
+	}
+
+	std::sort_heap(heap.begin(), heap.end(), less);
+
+	std::vector<size_t> rows;
+	rows.reserve(heap.size());
+	for (const auto& entry : heap)
+		rows.push_back(entry.row);
+
+	return rows;
+}
+
+// reorders rows so that row i becomes old row order[i] - every row is moved exactly once
+inline void apply_permutation(DataSet& ds, const std::vector<size_t>& order)
+{
+	assert(order.size() == ds.rows.size());
+
+	std::vector<Row> rows;
+	rows.reserve(ds.rows.size());
+
+	for (size_t i : order)
+		rows.push_back(std::move(ds.rows[i]));
+
+	ds.rows = std::move(rows);
+}
+
+inline void sort_by_column(DataSet& ds, size_t column, SortOrder order = SortOrder::Ascending, size_t threads = 1)
+{
+	apply_permutation(ds, threads > 1 ? parallel_sort_order(ds, column, threads, order) : sort_order(ds, column, order));
+}
+
+// merges two DataSets sorted by column - rows are moved, equal keys keep lhs rows first
+inline DataSet merge_by_column(DataSet&& lhs, DataSet&& rhs, size_t column, SortOrder order = SortOrder::Ascending)
+{
+	auto key_less = [column, order](const Row& a, const Row& b) {
+		if (column >= b.size())
+			return column < a.size();
+		if (column >= a.size())
+			return false;
+		return SortDetail::sort_key(a[column], order) < SortDetail::sort_key(b[column], order);
+	};
+
+	DataSet result;
+	result.rows.reserve(lhs.rows.size() + rhs.rows.size());
+
+	std::merge(std::make_move_iterator(lhs.rows.begin()), std::make_move_iterator(lhs.rows.end()),
+		std::make_move_iterator(rhs.rows.begin()), std::make_move_iterator(rhs.rows.end()),
+		std::back_inserter(result.rows), key_less);
+
+	lhs.rows.clear();
+	rhs.rows.clear();
+
+	return result;
+}
+
+#endif /*DATASET_SORT_HPP_*/
@@ -0,0 +1,158 @@
+#ifndef GENERATOR_HPP_
+#define GENERATOR_HPP_
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// Lazy sequence produced by a C++20 coroutine (co_yield) - a minimal std::generator (C++23)
+// - the coroutine runs only when the consumer asks for the next value (begin() / ++it)
+// - a yielded value is not copied: the iterator refers to it until the coroutine is resumed
+// - an exception thrown in the coroutine is rethrown from begin() / ++it
+template <typename T>
+class Generator
+{
+public:
+	struct promise_type
+	{
+		const T* current = nullptr;
+		std::exception_ptr error;
+
+		Generator get_return_object()
+		{
+			return Generator{ std::coroutine_handle<promise_type>::from_promise(*this) };
+		}
+
+		std::suspend_always initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		std::suspend_always final_suspend() noexcept
+		{
+			return {};
+		}
+
+		// the yielded object lives in the coroutine frame until the coroutine is resumed
+		std::suspend_always yield_value(const T& value) noexcept
+		{
+			current = std::addressof(value);
+			return {};
+		}
+
+		void return_void() noexcept
+		{
+		}
+
+		void unhandled_exception()
+		{
+			error = std::current_exception();
+		}
+
+		template <typename U>
+		void await_transform(U&&) = delete; // co_await is not supported in a generator
+	};
+
+	using Handle = std::coroutine_handle<promise_type>;
+
+	class iterator
+	{
+		Handle coroutine_;
+
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		iterator() = default;
+
+		explicit iterator(Handle coroutine) : coroutine_{ coroutine }
+		{
+		}
+
+		reference operator*() const
+		{
+			return *coroutine_.promise().current;
+		}
+
+		pointer operator->() const
+		{
+			return coroutine_.promise().current;
+		}
+
+		iterator& operator++()
+		{
+			resume(coroutine_);
+			return *this;
+		}
+
+		void operator++(int)
+		{
+			++*this;
+		}
+
+		bool operator==(std::default_sentinel_t) const
+		{
+			return !coroutine_ || coroutine_.done();
+		}
+	};
+
+private:
+	Handle coroutine_;
+
+	explicit Generator(Handle coroutine) : coroutine_{ coroutine }
+	{
+	}
+
+	static void resume(Handle coroutine)
+	{
+		coroutine.resume();
+		if (coroutine.done() && coroutine.promise().error)
+			std::rethrow_exception(std::exchange(coroutine.promise().error, nullptr));
+	}
+
+public:
+	Generator(const Generator&) = delete;
+	Generator& operator=(const Generator&) = delete;
+
+	Generator(Generator&& other) noexcept : coroutine_{ std::exchange(other.coroutine_, nullptr) }
+	{
+	}
+
+	Generator& operator=(Generator&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (coroutine_)
+				coroutine_.destroy();
+			coroutine_ = std::exchange(other.coroutine_, nullptr);
+		}
+
+		return *this;
+	}
+
+	~Generator()
+	{
+		if (coroutine_)
+			coroutine_.destroy();
+	}
+
+	// starts the coroutine - a generator can be iterated once
+	iterator begin()
+	{
+		if (coroutine_)
+			resume(coroutine_);
+		return iterator{ coroutine_ };
+	}
+
+	std::default_sentinel_t end() const noexcept
+	{
+		return {};
+	}
+};
+
+#endif /*GENERATOR_HPP_*/
@@ -0,0 +1,149 @@
+#ifndef HUGE_PAGE_STORAGE_HPP_
+#define HUGE_PAGE_STORAGE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "array.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Storage policy for large arrays (BasicArray<T, HugePageStorage<>>)
+// - Linux: blocks of at least 2 MiB are mapped with mmap, aligned to 2 MiB & marked with MADV_HUGEPAGE,
+//   so transparent huge pages can back them (fewer TLB misses & page faults)
+// - smaller blocks or kernels without THP fall back to the heap / regular pages - behaviour is the same, only slower
+// - Windows (& every platform other than Linux): always the heap fallback - large pages there need
+//   SeLockMemoryPrivilege (VirtualAlloc with MEM_LARGE_PAGES), which is not attempted
+// - ParallelFirstTouch: BasicArray(size, value) fills the elements in chunks on temporary threads
+//   (one per hardware thread, joined before the constructor returns), so the first touch of the pages
+//   (& their NUMA placement) is spread over the cores instead of landing on the node of the constructing thread;
+//   it is not tied to the threads that process the array later (e.g. a ThreadPool) - the OS schedules both
+template <bool ParallelFirstTouch = false>
+struct HugePageStorage
+{
+    static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+    template <typename T>
+    static T* allocate(size_t size)
+    {
+        const size_t bytes = size * sizeof(T);
+
+        if (!is_mapped(bytes))
+            return HeapStorage::allocate<T>(size);
+
+#if defined(__linux__)
+        const size_t length = round_up(bytes);
+
+        // over-map by one huge page & trim, so the block starts at a 2 MiB boundary
+        void* raw = ::mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            throw std::bad_alloc{};
+
+        const auto start = reinterpret_cast<uintptr_t>(raw);
+        const auto aligned = (start + huge_page_size - 1) & ~(uintptr_t{ huge_page_size } - 1);
+
+        if (aligned != start)
+            ::munmap(raw, aligned - start);
+        if (const size_t tail = huge_page_size - (aligned - start); tail != 0)
+            ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+
+#if defined(MADV_HUGEPAGE)
+        ::madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE); // advice only - failure is not an error
+#endif
+
+        return reinterpret_cast<T*>(aligned);
+#else
+        return HeapStorage::allocate<T>(size);
+#endif
+    }
+
+    template <typename T>
+    static void deallocate(T* data, size_t size) noexcept
+    {
+        const size_t bytes = size * sizeof(T);
+
+        if (!is_mapped(bytes))
+        {
+            HeapStorage::deallocate(data, size);
+            return;
+        }
+
+#if defined(__linux__)
+        ::munmap(data, round_up(bytes));
+#endif
+    }
+
+    template <typename T>
+    static void uninitialized_fill(T* data, size_t size, const T& value)
+    {
+        if constexpr (ParallelFirstTouch && std::is_nothrow_copy_constructible_v<T>)
+        {
+            const size_t threads = std::thread::hardware_concurrency();
+
+            if (threads > 1 && size * sizeof(T) >= huge_page_size)
+            {
+                const size_t chunk = (size + threads - 1) / threads;
+
+                std::vector<std::thread> workers;
+                workers.reserve(threads - 1);
+
+                for (size_t first = chunk; first < size; first += chunk)
+                {
+                    const size_t count = std::min(chunk, size - first);
+
+                    try
+                    {
+                        workers.emplace_back([=, &value] { std::uninitialized_fill_n(data + first, count, value); });
+                    }
+                    catch (const std::system_error&) // no more threads - the rest is filled here
+                    {
+                        std::uninitialized_fill_n(data + first, size - first, value);
+                        break;
+                    }
+                }
+
+                std::uninitialized_fill_n(data, std::min(chunk, size), value);
+
+                for (auto& worker : workers)
+                    worker.join();
+
+                return;
+            }
+        }
+
+        std::uninitialized_fill_n(data, size, value);
+    }
+
+private:
+    static bool is_mapped(size_t bytes)
+    {
+#if defined(__linux__)
+        return bytes >= huge_page_size;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static size_t round_up(size_t bytes)
+    {
+        return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+};
+
+template <typename T>
+using HugePageArray = BasicArray<T, HugePageStorage<>>;
+
+template <typename T>
+using FirstTouchArray = BasicArray<T, HugePageStorage<true>>;
+
+#endif /*HUGE_PAGE_STORAGE_HPP_*/
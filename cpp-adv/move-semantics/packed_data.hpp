@@ -0,0 +1,134 @@
+#ifndef PACKED_DATA_HPP_
+#define PACKED_DATA_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "array_view.hpp"
+#include "fast_output.hpp"
+
+// Data record (id, name, array of ints) in a single heap block:
+//   [ id | name size | item count | items... | name chars... ]
+// - one allocation per record instead of up to three (object, std::string, Array)
+// - sizeof(PackedData) is one pointer, so std::vector<PackedData> stays small & a record is read from one place
+// - name & items are always copied into the block - also from rvalues (their buffers can not be adopted)
+// A moved-from PackedData is empty (id 0, no name, no items).
+// Name & item count are limited to 2^32 - 1 (sizes are 32 bit).
+class PackedData
+{
+	struct Header
+	{
+		int id;
+		uint32_t name_size;
+		uint32_t size;
+	};
+
+	static_assert(alignof(Header) >= alignof(int));
+
+	Header* block_ = nullptr;
+
+	static Header* allocate(int id, std::string_view name, size_t size)
+	{
+		if (name.size() > std::numeric_limits<uint32_t>::max() || size > std::numeric_limits<uint32_t>::max())
+			throw std::length_error("PackedData: name or items longer than 2^32 - 1");
+
+		void* raw = ::operator new(sizeof(Header) + size * sizeof(int) + name.size());
+		Header* header = new (raw) Header{ id, static_cast<uint32_t>(name.size()), static_cast<uint32_t>(size) };
+		if (!name.empty()) // data() of an empty view may be null
+			std::memcpy(reinterpret_cast<char*>(reinterpret_cast<int*>(header + 1) + size), name.data(), name.size());
+		return header;
+	}
+
+	int* items() const
+	{
+		return block_ ? reinterpret_cast<int*>(block_ + 1) : nullptr;
+	}
+
+public:
+	template <typename TName, typename TArrayArg>
+	PackedData(int id, TName&& name, TArrayArg&& data)
+	{
+		const std::string_view name_view{ name };
+		const size_t size = std::size(data);
+
+		block_ = allocate(id, name_view, size);
+		std::copy_n(std::begin(data), size, items());
+	}
+
+	PackedData(const PackedData& other)
+	{
+		if (other.block_)
+		{
+			block_ = allocate(other.id(), other.name(), other.block_->size);
+			std::copy_n(other.items(), other.block_->size, items());
+		}
+	}
+
+	PackedData& operator=(const PackedData& other)
+	{
+		PackedData temp(other);
+		swap(temp);
+		return *this;
+	}
+
+	PackedData(PackedData&& other) noexcept : block_{ std::exchange(other.block_, nullptr) }
+	{
+	}
+
+	PackedData& operator=(PackedData&& other) noexcept
+	{
+		PackedData temp(std::move(other));
+		swap(temp);
+		return *this;
+	}
+
+	~PackedData()
+	{
+		::operator delete(block_);
+	}
+
+	void swap(PackedData& other) noexcept
+	{
+		std::swap(block_, other.block_);
+	}
+
+	int id() const
+	{
+		return block_ ? block_->id : 0;
+	}
+
+	std::string_view name() const
+	{
+		if (!block_)
+			return {};
+		return std::string_view(reinterpret_cast<const char*>(items() + block_->size), block_->name_size);
+	}
+
+	ArrayView<int> data()
+	{
+		return ArrayView<int>(items(), block_ ? block_->size : 0);
+	}
+
+	ArrayView<const int> data() const
+	{
+		return ArrayView<const int>(items(), block_ ? block_->size : 0);
+	}
+
+	void print() const
+	{
+		FastOutput::Writer out;
+		out << "Data(" << id() << ", \"" << name() << "\", [ ";
+		for (const auto& item : data())
+			out << item << " ";
+		out << "])\n";
+	}
+};
+
+#endif /*PACKED_DATA_HPP_*/
@@ -0,0 +1,170 @@
+#ifndef QUERY_HPP_
+#define QUERY_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class ThreadPool; // thread_pool.hpp - needed only where reduce(init, op, pool) is called
+
+// Lazy query over a range: query.filter(...).map(...).reduce(...)
+// - filter() & map() only compose stages; nothing runs until reduce() / count() / for_each()
+// - stages are fused into one function object that pushes every item through the whole chain,
+//   so the pipeline is a single pass with no intermediate containers & all lambdas can be inlined
+// - reduce(init, op, threads) splits the source into chunks reduced in parallel (std::async);
+//   reduce(init, op, pool) does the same on a ThreadPool;
+//   op must be associative & init its identity (partial results are combined with op)
+// The source range must outlive the query.
+namespace QueryDetail
+{
+	struct Identity
+	{
+		template <typename T, typename TSink>
+		void operator()(T&& item, TSink&& sink) const
+		{
+			sink(std::forward<T>(item));
+		}
+	};
+
+	template <typename TPrevious, typename TPredicate>
+	struct Filter
+	{
+		TPrevious previous;
+		TPredicate predicate;
+
+		template <typename T, typename TSink>
+		void operator()(T&& item, TSink&& sink) const
+		{
+			previous(std::forward<T>(item), [this, &sink](auto&& value) {
+				if (predicate(value))
+					sink(std::forward<decltype(value)>(value));
+			});
+		}
+	};
+
+	template <typename TPrevious, typename TFunction>
+	struct Map
+	{
+		TPrevious previous;
+		TFunction function;
+
+		template <typename T, typename TSink>
+		void operator()(T&& item, TSink&& sink) const
+		{
+			previous(std::forward<T>(item), [this, &sink](auto&& value) {
+				sink(function(std::forward<decltype(value)>(value)));
+			});
+		}
+	};
+}
+
+template <typename TRange, typename TStage = QueryDetail::Identity>
+class Query
+{
+	const TRange* source_;
+	TStage stage_;
+
+	template <typename TResult, typename TOperation>
+	TResult reduce_range(size_t first, size_t last, TResult init, TOperation& op) const
+	{
+		auto it = std::next(std::begin(*source_), first);
+		for (size_t i = first; i < last; ++i, ++it)
+			stage_(*it, [&init, &op](auto&& value) { init = op(std::move(init), std::forward<decltype(value)>(value)); });
+		return init;
+	}
+
+public:
+	explicit Query(const TRange& source, TStage stage = TStage{}) : source_{ &source }, stage_{ std::move(stage) }
+	{
+	}
+
+	template <typename TPredicate>
+	auto filter(TPredicate predicate) const
+	{
+		using Stage = QueryDetail::Filter<TStage, TPredicate>;
+		return Query<TRange, Stage>{ *source_, Stage{ stage_, std::move(predicate) } };
+	}
+
+	template <typename TFunction>
+	auto map(TFunction function) const
+	{
+		using Stage = QueryDetail::Map<TStage, TFunction>;
+		return Query<TRange, Stage>{ *source_, Stage{ stage_, std::move(function) } };
+	}
+
+	template <typename TFunction>
+	void for_each(TFunction f) const
+	{
+		for (const auto& item : *source_)
+			stage_(item, f);
+	}
+
+	template <typename TResult, typename TOperation>
+	TResult reduce(TResult init, TOperation op) const
+	{
+		for (const auto& item : *source_)
+			stage_(item, [&init, &op](auto&& value) { init = op(std::move(init), std::forward<decltype(value)>(value)); });
+		return init;
+	}
+
+	template <typename TResult, typename TOperation>
+	TResult reduce(TResult init, TOperation op, size_t threads) const
+	{
+		const size_t size = static_cast<size_t>(std::distance(std::begin(*source_), std::end(*source_)));
+		if (threads <= 1 || size < 2 * threads)
+			return reduce(std::move(init), op);
+
+		const size_t chunk = (size + threads - 1) / threads;
+
+		std::vector<std::future<TResult>> partials;
+		for (size_t first = chunk; first < size; first += chunk)
+		{
+			partials.push_back(std::async(std::launch::async, [this, first, last = std::min(first + chunk, size), init, op]() mutable {
+				return reduce_range(first, last, std::move(init), op);
+			}));
+		}
+
+		TResult result = reduce_range(0, chunk, init, op);
+		for (auto& partial : partials)
+			result = op(std::move(result), partial.get());
+
+		return result;
+	}
+
+	// TPool is ThreadPool - a dependent type, so the pool is used only when the call is instantiated
+	template <typename TResult, typename TOperation, typename TPool, typename = std::enable_if_t<std::is_same_v<TPool, ThreadPool>>>
+	TResult reduce(TResult init, TOperation op, TPool& pool) const
+	{
+		const size_t size = static_cast<size_t>(std::distance(std::begin(*source_), std::end(*source_)));
+		const size_t chunks = std::min(size, 4 * pool.size());
+		if (chunks <= 1)
+			return reduce(std::move(init), op);
+
+		// fixed chunks, so partial results are combined in order
+		std::vector<TResult> partials(chunks, init);
+		pool.parallel_for(0, chunks, [&](size_t chunk) {
+			TOperation chunk_op = op;
+			partials[chunk] = reduce_range(chunk * size / chunks, (chunk + 1) * size / chunks, init, chunk_op);
+		}, 1);
+
+		TResult result = std::move(partials[0]);
+		for (size_t chunk = 1; chunk < chunks; ++chunk)
+			result = op(std::move(result), std::move(partials[chunk]));
+
+		return result;
+	}
+
+	size_t count() const
+	{
+		return reduce(size_t{ 0 }, [](size_t n, auto&&) { return n + 1; });
+	}
+};
+
+template <typename TRange>
+Query(const TRange&) -> Query<TRange>;
+
+#endif /*QUERY_HPP_*/
@@ -0,0 +1,62 @@
+#ifndef ROW_STREAM_HPP_
+#define ROW_STREAM_HPP_
+
+#include <istream>
+#include <vector>
+
+#include "array_view.hpp"
+#include "csv_loader.hpp"
+#include "dataset.hpp"
+#include "dataset_file.hpp"
+#include "generator.hpp"
+
+// Rows streamed one by one from memory or files - nothing is materialized as std::vector<Row>
+// - a RowView is valid until the next row is requested
+// - the source (DataSet, MappedDataSet, stream) must outlive the generator
+using RowView = ArrayView<const int>;
+
+inline Generator<RowView> stream_rows(const DataSet& ds)
+{
+	for (const auto& row : ds.rows)
+		co_yield RowView(row.data(), row.size());
+}
+
+// views straight into the file mapping - pages are read in as rows are consumed
+inline Generator<RowView> stream_rows(const MappedDataSet& file)
+{
+	for (size_t i = 0; i < file.size(); ++i)
+		co_yield file[i];
+}
+
+// text is read in chunks of options.chunk_size & parsed line by line into one reused buffer,
+// so memory use does not depend on the size of the input; options.threads is ignored
+inline Generator<RowView> stream_csv_rows(std::istream& in, Csv::Options options = {})
+{
+	Csv::ChunkReader reader{ in, options.chunk_size };
+	std::vector<int> values;
+
+	for (const char *first, *last; reader.next(first, last); )
+	{
+		for (const char* line = first; line != last; )
+		{
+			const char* eol = Csv::Detail::find_newline(line, last);
+
+			bool has_values;
+			try
+			{
+				has_values = Csv::Detail::parse_line(line, eol, options.delimiter, values);
+			}
+			catch (const Csv::Detail::ParseError& e)
+			{
+				throw reader.parse_error(e.position);
+			}
+
+			if (has_values)
+				co_yield RowView(values.data(), values.size());
+
+			line = (eol == last) ? last : eol + 1;
+		}
+	}
+}
+
+#endif /*ROW_STREAM_HPP_*/
@@ -0,0 +1,222 @@
+#ifndef SHARED_ARRAY_HPP_
+#define SHARED_ARRAY_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+#include "array.hpp"
+
+// Copy-on-write array of ints
+// - copies share one buffer (O(1), atomic reference count)
+// - first non-const access (operator[], begin(), end(), data(), reset) of a shared copy detaches it (deep copy)
+// Copies of one SharedArray may be used from many threads; a single SharedArray object is not thread-safe.
+// References obtained through non-const access are invalidated when the array is copied afterwards.
+// Traced like Array (ArrayTracing, EventLog) - a detach is recorded as a copy event.
+class SharedArray
+{
+    // header & elements live in a single allocation
+    struct Buffer
+    {
+        std::atomic<size_t> ref_count;
+        size_t size;
+
+        int* items()
+        {
+            return reinterpret_cast<int*>(this + 1);
+        }
+
+        static Buffer* create(size_t size)
+        {
+            static_assert(alignof(Buffer) >= alignof(int));
+
+            void* raw = ::operator new(sizeof(Buffer) + size * sizeof(int));
+            return ::new (raw) Buffer{ { 1 }, size };
+        }
+
+        static void destroy(Buffer* buffer) noexcept
+        {
+            buffer->~Buffer();
+            ::operator delete(buffer);
+        }
+    };
+
+    Buffer* buffer_;
+
+    void release() noexcept
+    {
+        if (buffer_ != nullptr && buffer_->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Buffer::destroy(buffer_);
+    }
+
+    void detach()
+    {
+        if (buffer_ != nullptr && buffer_->ref_count.load(std::memory_order_acquire) > 1)
+        {
+            Buffer* unique = Buffer::create(buffer_->size);
+            std::copy_n(buffer_->items(), buffer_->size, unique->items());
+
+            release();
+            buffer_ = unique;
+
+            ArrayTracing::trace(EventLog::EventType::CopyConstruct, this, "SharedArray - detach (deep copy)");
+        }
+    }
+
+public:
+    using iterator = int*;
+    using const_iterator = const int*;
+
+    SharedArray(std::initializer_list<int> il) : buffer_{ Buffer::create(il.size()) }
+    {
+        std::copy(il.begin(), il.end(), buffer_->items());
+        ArrayTracing::trace(EventLog::EventType::Construct, this, "SharedArray({ ... })");
+    }
+
+    explicit SharedArray(size_t size, int value = 0) : buffer_{ Buffer::create(size) }
+    {
+        std::fill_n(buffer_->items(), size, value);
+        if (ArrayTracing::is_enabled() && !EventLog::record(EventLog::EventType::Construct, this, "SharedArray(size)"))
+            FastOutput::Writer{} << "SharedArray(size: " << size << ")\n";
+    }
+
+    explicit SharedArray(const Array& source) : buffer_{ Buffer::create(source.size()) }
+    {
+        std::copy(source.begin(), source.end(), buffer_->items());
+        ArrayTracing::trace(EventLog::EventType::CopyConstruct, this, "SharedArray(const Array&)"); // elements are copied
+    }
+
+    // shares the buffer - no allocation, no copy of elements
+    SharedArray(const SharedArray& source) noexcept : buffer_{ source.buffer_ }
+    {
+        if (buffer_ != nullptr)
+            buffer_->ref_count.fetch_add(1, std::memory_order_relaxed);
+
+        ArrayTracing::trace(EventLog::EventType::Construct, this, "SharedArray(const SharedArray& - shared copy)"); // no deep copy
+    }
+
+    SharedArray& operator=(const SharedArray& source) noexcept
+    {
+        SharedArray temp(source);
+        swap(temp);
+
+        return *this;
+    }
+
+    SharedArray(SharedArray&& source) noexcept : buffer_{ source.buffer_ }
+    {
+        source.buffer_ = nullptr;
+    }
+
+    SharedArray& operator=(SharedArray&& source) noexcept
+    {
+        if (this != &source)
+        {
+            release();
+
+            buffer_ = source.buffer_;
+            source.buffer_ = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~SharedArray() noexcept
+    {
+        release();
+    }
+
+    void swap(SharedArray& other) noexcept
+    {
+        std::swap(buffer_, other.buffer_);
+    }
+
+    size_t size() const
+    {
+        return buffer_ != nullptr ? buffer_->size : 0;
+    }
+
+    size_t use_count() const
+    {
+        return buffer_ != nullptr ? buffer_->ref_count.load(std::memory_order_relaxed) : 0;
+    }
+
+    const int* data() const
+    {
+        return buffer_ != nullptr ? buffer_->items() : nullptr;
+    }
+
+    int* data()
+    {
+        detach();
+        return buffer_ != nullptr ? buffer_->items() : nullptr;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + size();
+    }
+
+    const int& operator[](size_t index) const
+    {
+        return buffer_->items()[index];
+    }
+
+    int& operator[](size_t index)
+    {
+        detach();
+        return buffer_->items()[index];
+    }
+
+    void reset(int value)
+    {
+        if (buffer_ != nullptr && use_count() > 1)
+        {
+            // no point in copying elements that are overwritten anyway
+            SharedArray filled(buffer_->size, value);
+            swap(filled);
+        }
+        else
+        {
+            std::fill_n(data(), size(), value);
+        }
+    }
+
+    friend bool operator==(const SharedArray& lhs, const SharedArray& rhs)
+    {
+        if (lhs.buffer_ == rhs.buffer_)
+            return true;
+
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+};
+
+#endif /*SHARED_ARRAY_HPP_*/
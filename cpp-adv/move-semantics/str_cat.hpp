@@ -0,0 +1,107 @@
+#ifndef STR_CAT_HPP_
+#define STR_CAT_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Concatenation with a single allocation:
+//   concat(first, " ", last, '#', id) instead of first + " " + last + "#" + std::to_string(id)
+// - the length of all pieces is computed first, so the result is allocated once (no temporaries, no regrowth)
+// - pieces: anything convertible to std::string_view (std::string, literals, const char*), char & integers
+//   (formatted with std::to_chars - no locale, no allocation)
+// - concat_to(out, ...) appends to an existing string - reusing its buffer in a loop allocates only when it grows;
+//   pieces may be views into out (concat_to(s, s))
+namespace ConcatDetail
+{
+	struct FormattedInteger
+	{
+		char data[24];
+		size_t size;
+
+		template <typename T>
+		explicit FormattedInteger(T value) : size{ static_cast<size_t>(std::to_chars(data, data + sizeof(data), value).ptr - data) }
+		{
+		}
+
+		operator std::string_view() const
+		{
+			return std::string_view(data, size);
+		}
+	};
+
+	template <typename T>
+	auto to_piece(const T& value)
+	{
+		if constexpr (std::is_same_v<T, char>)
+			return std::string_view(&value, 1);
+		else if constexpr (std::is_integral_v<T>)
+		{
+			static_assert(!std::is_same_v<T, bool>, "concat: bool is ambiguous - pass a string");
+			return FormattedInteger{ value };
+		}
+		else
+			return std::string_view(value);
+	}
+
+	// piece is a view into text
+	inline bool aliases(const std::string& text, std::string_view piece)
+	{
+		const std::less<const char*> less;
+		return !less(piece.data(), text.data()) && !less(text.data() + text.size(), piece.data());
+	}
+
+	template <typename... TPiece>
+	void append(std::string& out, size_t capacity, const TPiece&... pieces)
+	{
+		out.reserve(capacity);
+		(out.append(static_cast<std::string_view>(pieces)), ...);
+	}
+}
+
+template <typename... TArgs>
+void concat_to(std::string& out, const TArgs&... args)
+{
+	const std::tuple pieces{ ConcatDetail::to_piece(args)... };
+
+	std::apply([&out](const auto&... piece) {
+		const size_t size = (out.size() + ... + static_cast<std::string_view>(piece).size());
+		if (size <= out.capacity())
+		{
+			ConcatDetail::append(out, size, piece...); // no reallocation - pieces that view out stay valid
+			return;
+		}
+
+		// geometric growth keeps repeated appends to the same string amortized O(1)
+		const size_t capacity = std::max(size, 2 * out.capacity());
+
+		if ((ConcatDetail::aliases(out, piece) || ...))
+		{
+			// reallocation of out would invalidate the pieces that view it - built in a new buffer instead
+			std::string result;
+			ConcatDetail::append(result, capacity, std::string_view(out), piece...);
+			out = std::move(result);
+		}
+		else
+			ConcatDetail::append(out, capacity, piece...);
+	}, pieces);
+}
+
+template <typename... TArgs>
+std::string concat(const TArgs&... args)
+{
+	const std::tuple pieces{ ConcatDetail::to_piece(args)... };
+
+	return std::apply([](const auto&... piece) {
+		std::string result;
+		ConcatDetail::append(result, (size_t{ 0 } + ... + static_cast<std::string_view>(piece).size()), piece...);
+		return result;
+	}, pieces);
+}
+
+#endif /*STR_CAT_HPP_*/
@@ -0,0 +1,192 @@
+#ifndef STRING_TABLE_HPP_
+#define STRING_TABLE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "str_cat.hpp"
+
+// Sequence of strings stored back to back in one character arena + index of offsets
+// - no allocation per string: a table of short labels needs two growing buffers instead of one block per string
+// - elements are std::string_view - invalidated (like iterators of std::vector) when the table grows
+// - the first std::string moved into an empty table becomes the arena (its buffer is adopted, not copied)
+// Total size of all strings is limited to 4 GiB (offsets are 32 bit).
+class StringTable
+{
+	std::string chars_;
+	std::vector<uint32_t> offsets_{ 0 }; // string i is chars_[offsets_[i], offsets_[i + 1])
+
+	// adds one string with append() - on failure (length_error, bad_alloc) the table is left as it was
+	template <typename TAppend>
+	void push(TAppend append)
+	{
+		offsets_.push_back(offsets_.back()); // slot for the end of the new string - reserved before chars_ changes
+		const size_t old_size = chars_.size();
+
+		try
+		{
+			append();
+			if (chars_.size() > std::numeric_limits<uint32_t>::max())
+				throw std::length_error("StringTable: more than 4 GiB of characters");
+		}
+		catch (...)
+		{
+			chars_.resize(old_size);
+			offsets_.pop_back();
+			throw;
+		}
+
+		offsets_.back() = static_cast<uint32_t>(chars_.size());
+	}
+
+public:
+	class const_iterator
+	{
+		const StringTable* table_ = nullptr;
+		size_t index_ = 0;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::string_view;
+
+		const_iterator() = default;
+
+		const_iterator(const StringTable* table, size_t index) : table_{ table }, index_{ index }
+		{
+		}
+
+		std::string_view operator*() const
+		{
+			return (*table_)[index_];
+		}
+
+		const_iterator& operator++()
+		{
+			++index_;
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator it = *this;
+			++index_;
+			return it;
+		}
+
+		bool operator==(const const_iterator& other) const
+		{
+			return index_ == other.index_;
+		}
+
+		bool operator!=(const const_iterator& other) const
+		{
+			return index_ != other.index_;
+		}
+	};
+
+	using value_type = std::string_view;
+
+	StringTable() = default;
+
+	StringTable(std::initializer_list<std::string_view> il)
+	{
+		size_t total_size = 0;
+		for (const auto& text : il)
+			total_size += text.size();
+		reserve(il.size(), total_size);
+
+		for (const auto& text : il)
+			push_back(text);
+	}
+
+	void reserve(size_t count, size_t total_size)
+	{
+		offsets_.reserve(count + 1);
+		chars_.reserve(total_size);
+	}
+
+	void push_back(std::string_view text)
+	{
+		push([this, text] { chars_.append(text); });
+	}
+
+	void push_back(const char* text)
+	{
+		push_back(std::string_view(text));
+	}
+
+	void push_back(std::string&& text)
+	{
+		push([this, &text] {
+			if (chars_.empty() && chars_.capacity() < text.capacity())
+				chars_ = std::move(text);
+			else
+				chars_.append(text);
+		});
+	}
+
+	// one string concatenated from pieces (see concat) straight in the arena - append_concat(str, str) instead of
+	// push_back(str + str); pieces may be elements of the table
+	template <typename... TArgs>
+	void append_concat(const TArgs&... pieces)
+	{
+		push([&] { concat_to(chars_, pieces...); });
+	}
+
+	std::string_view operator[](size_t index) const
+	{
+		return std::string_view(chars_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+	}
+
+	std::string_view at(size_t index) const
+	{
+		if (index >= size())
+			throw std::out_of_range("StringTable: index out of range");
+		return (*this)[index];
+	}
+
+	size_t size() const
+	{
+		return offsets_.size() - 1;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	// size of all strings
+	size_t chars_size() const
+	{
+		return chars_.size();
+	}
+
+	void clear()
+	{
+		chars_.clear();
+		offsets_.resize(1);
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator{ this, 0 };
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator{ this, size() };
+	}
+};
+
+#endif /*STRING_TABLE_HPP_*/
@@ -5,14 +5,59 @@
 #include <vector>
 #include <tuple>
 #include <memory>
+#include <utility>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <filesystem>
+#include <sstream>
+#include <fstream>
+#include <map>
+#include <random>
+#include <cmath>
+#include <atomic>
+#include <chrono>
 
 #include "catch.hpp"
+#include "array.hpp"
+#include "array_expr.hpp"
+#include "array_view.hpp"
+#include "shared_array.hpp"
+#include "huge_page_storage.hpp"
+#include "dataset.hpp"
+#include "concurrent_dataset.hpp"
+#include "dataset_file.hpp"
+#include "csv_loader.hpp"
+#include "dataset_index.hpp"
+#include "compressed_dataset.hpp"
+#include "dataset_sort.hpp"
+#include "query.hpp"
+#include "thread_pool.hpp"
+#include "row_stream.hpp"
+#include "packed_data.hpp"
+#include "fast_output.hpp"
+#include "event_log.hpp"
+#include "chrome_trace.hpp"
+#include "str_cat.hpp"
+#include "string_table.hpp"
 
 using namespace std;
 
+namespace
+{
+	// path in the temp directory unique to this run - parallel test runs do not clobber each other's files
+	std::string unique_temp_path(const std::string& name, const std::string& extension)
+	{
+		static std::atomic<unsigned> counter{ 0 };
+		const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+		const std::string unique = std::to_string(std::random_device{}()) + "-" + std::to_string(stamp) + "-" + std::to_string(counter++);
+		return (std::filesystem::temp_directory_path() / (name + "-" + unique + extension)).string();
+	}
+}
+
 string full_name(const string& first, const string& last)
 {
-    return first + " " + last;
+    return concat(first, " ", last); // one allocation - first + " " + last may allocate twice
 }
 
 TEST_CASE("reference binding")
@@ -40,6 +85,85 @@ TEST_CASE("reference binding")
     }
 }
 
+TEST_CASE("concat")
+{
+    SECTION("strings, literals, chars & integers")
+    {
+        const std::string first = "Jan";
+        const std::string_view last = "Kowalski";
+
+        REQUIRE(concat(first, " ", last, '#', 42, " ", -7LL, " ", 18'446'744'073'709'551'615u) == "Jan Kowalski#42 -7 18446744073709551615");
+        REQUIRE(concat() == "");
+    }
+
+    SECTION("size is computed before appending")
+    {
+        const std::string long_text(100, 'x');
+
+        std::string result;
+        result.reserve(205);
+        const char* buffer = result.data();
+
+        concat_to(result, long_text, "-", 123, "-", long_text);
+
+        REQUIRE(result.size() == 205);
+        REQUIRE(result.data() == buffer); // exactly enough capacity - no regrowth between the pieces
+    }
+
+    SECTION("pieces may view the target of concat_to")
+    {
+        std::string text = "abcdef";
+        concat_to(text, text, '-', std::string_view(text).substr(2));
+        REQUIRE(text == "abcdefabcdef-cdef");
+
+        text.reserve(100); // no reallocation
+        concat_to(text, std::string_view(text).substr(0, 3));
+        REQUIRE(text == "abcdefabcdef-cdefabc");
+    }
+
+    SECTION("concat_to appends to an existing buffer")
+    {
+        std::string key = "user:";
+        concat_to(key, 17, ':', "orders");
+        REQUIRE(key == "user:17:orders");
+
+        std::string buffer;
+        buffer.reserve(64);
+        const char* storage = buffer.data();
+        for (int i = 0; i < 1000; ++i)
+        {
+            buffer.clear();
+            concat_to(buffer, "key:", i, ':', i * 2);
+        }
+        REQUIRE(buffer == "key:999:1998");
+        REQUIRE(buffer.data() == storage); // buffer reused
+    }
+}
+
+TEST_CASE("concat - benchmark", "[.benchmark]")
+{
+    const std::string first = "Jan-Maria-Konstanty";
+    const std::string last = "Kowalski-Brzeczyszczykiewicz";
+
+    BENCHMARK("operator+")
+    {
+        return first + " " + last + "#" + std::to_string(12345);
+    };
+
+    BENCHMARK("concat")
+    {
+        return concat(first, " ", last, '#', 12345);
+    };
+
+    std::string buffer;
+    BENCHMARK("concat_to - reused buffer")
+    {
+        buffer.clear();
+        concat_to(buffer, first, " ", last, '#', 12345);
+        return buffer.size();
+    };
+}
+
 std::vector<std::string> create_and_fill_rvo()
 {
     return std::vector{"one"s, "two"s, "three"s}; // prvalue
@@ -62,199 +186,398 @@ std::vector<std::string> create_and_fill_nrvo()
     return vec; // lvalue
 }
 
+// strings in one arena - no allocation per string
+StringTable create_and_fill_table()
+{
+    StringTable table;
+    table.reserve(4, 20);
+
+    std::string str = "text";
+
+    table.push_back(str);
+
+    table.append_concat(str, str);
+
+    table.push_back("text");
+
+    table.push_back(std::move(str));
+
+    return table;
+}
+
 TEST_CASE("create & fill")
 {
     std::vector vec1 = create_and_fill_rvo(); 
     std::vector vec2 = create_and_fill_nrvo(); // NRVO (Named Return Value Optimization)
+
+    StringTable table = create_and_fill_table();
+    REQUIRE(std::equal(table.begin(), table.end(), vec2.begin(), vec2.end()));
 }
 
-class Array
+TEST_CASE("StringTable")
 {
-private:
-	size_t size_;
-	int* data_;
-public:
-	typedef int* iterator; // legacy style
-	using const_iterator = const int*; // since C++11
+    StringTable table = { "one", "", "three" };
 
-									   // allows list initialization: Array a = {1, 2, 3}
-	Array(std::initializer_list<int> il)
-		: size_(il.size()), data_(new int[il.size()])
-	{
-		std::copy(il.begin(), il.end(), data_);
-		std::cout << "Array({ ";
-		for (const auto& item : il)
-			std::cout << item << " ";
-		std::cout << "})\n";
-	}
+    REQUIRE(table.size() == 3);
+    REQUIRE(table[0] == "one");
+    REQUIRE(table[1].empty());
+    REQUIRE(table.at(2) == "three");
+    REQUIRE(table.chars_size() == 8);
+    REQUIRE_THROWS_AS(table.at(3), std::out_of_range);
 
-	// copy constructor
-	Array(const Array& source) : size_(source.size_), data_(new int[source.size_])
-	{
-		std::copy(source.begin(), source.end(), this->data_);
-		std::cout << "Array(const Array& - copy constructor)\n";
-	}
+    SECTION("strings are stored back to back")
+    {
+        REQUIRE(table[2].data() == table[0].data() + 3);
+    }
 
-	// copy assignment operator
-	Array& operator=(const Array& source)
-	{
-		if (this != &source) // protection from self-assignment
-		{
-			delete[] data_; // free memory
+    SECTION("append_concat concatenates in place")
+    {
+        table.append_concat("id:", 42);
+        REQUIRE(table[3] == "id:42");
 
-			// copy of state from source object
-			size_ = source.size_;
-			data_ = new int[size_];
-			std::copy(source.begin(), source.end(), data_);
-		}
+        for (int i = 0; i < 100; ++i) // growth of the arena while a piece views it
+            table.append_concat(table[0], '-', table[table.size() - 1]);
+        REQUIRE(table[4] == "one-id:42");
+        REQUIRE(table[5] == "one-one-id:42");
+    }
 
-		std::cout << "Array operator=(const Array& - copy assignment)\n";
-		return *this;
-	}
+    SECTION("failed append leaves the table unchanged")
+    {
+        struct BrokenPiece
+        {
+            operator std::string_view() const
+            {
+                throw std::runtime_error("broken piece");
+            }
+        };
+
+        REQUIRE_THROWS_AS(table.append_concat("id:", BrokenPiece{}), std::runtime_error);
+        REQUIRE(table.size() == 3);
+        REQUIRE(table.chars_size() == 8);
+
+        table.push_back("next");
+        REQUIRE(table[3] == "next");
+    }
 
-	Array(Array&& source) noexcept : size_{source.size_}, data_{source.data_} // transfer of state
-	{	
-		// set to resourceless state
-		source.size_ = 0; // optional
-		source.data_ = nullptr; // mandatory
+    SECTION("no allocation per string")
+    {
+        StringTable labels;
+        labels.reserve(1'000, 16'000);
+        labels.append_concat("label-", 0);
+        const char* arena = labels[0].data();
 
-		std::cout << "Array(Array&& - move constructor)\n";
-	}
+        for (int i = 1; i < 1'000; ++i)
+            labels.append_concat("label-", i);
 
-	Array& operator=(Array&& source) noexcept
-	{
-		if (this != &source) // a = std::move(a) - self assignment protection
-		{
-			delete[] data_;
+        REQUIRE(labels[999] == "label-999");
+        REQUIRE(labels[0].data() == arena); // all strings went into the reserved arena
+        REQUIRE(labels[999].data() == arena + labels.chars_size() - 9);
+    }
 
-			size_ = source.size_;
-			data_ = source.data_;
+    SECTION("first moved-in string becomes the arena")
+    {
+        StringTable other;
+        std::string text(100, 'x');
+        const char* buffer = text.data();
 
-			source.size_ = 0; // optional
-			source.data_ = nullptr; // mandatory
-		}
-		std::cout << "Array operator=(Array&& - move assignment)\n";
+        other.push_back(std::move(text));
+        REQUIRE(other[0].data() == buffer);
 
-		return *this;
-	}
+        other.push_back("y");
+        REQUIRE(other[0] == std::string(100, 'x'));
+        REQUIRE(other[1] == "y");
+    }
+
+    SECTION("clear")
+    {
+        table.clear();
+        REQUIRE(table.empty());
+        REQUIRE(table.begin() == table.end());
+    }
+}
+
+TEST_CASE("StringTable - benchmark", "[.benchmark]")
+{
+    std::vector<std::string> labels;
+    for (int i = 0; i < 10'000; ++i)
+        labels.push_back(concat("label-with-long-name-", i));
+
+    BENCHMARK("std::vector<std::string> - push_back")
+    {
+        std::vector<std::string> vec;
+        for (const auto& label : labels)
+            vec.push_back(label);
+        return vec.size();
+    };
+
+    BENCHMARK("StringTable - push_back")
+    {
+        StringTable table;
+        for (const auto& label : labels)
+            table.push_back(label);
+        return table.size();
+    };
+}
+
+Array create_array()
+{
+	Array arr = { 1, 2, 3, 4, 5 };
+
+	for (auto& item : arr)
+		item *= 2;
+
+	return arr;
+}
+
+TEST_CASE("Array")
+{
+	Array arr = create_array();
+
+	Array other = std::move(arr); // move constructor
+
+	Array another = { 1, 2, 3 };
+
+	another = std::move(other); // move assignment
+
+	REQUIRE(another == Array{ 2, 4, 6, 8, 10 });
 
-	// destructor
-	~Array() noexcept
+	SECTION("move does not move")
 	{
-		std::cout << "~Array()\n";
-		delete[] data_;
+		const Array carr = { 1, 2, 3 };
+
+		Array target = std::move(carr);
+
+		REQUIRE(carr.size() == 3);
 	}
+}
+
+TEST_CASE("Array - expression templates")
+{
+	const Array a = { 1, 2, 3 };
+	const Array b = { 4, 5, 6 };
+	const Array c = { 7, 8, 9 };
+
+	auto expr = a + b * c;
+	static_assert(!std::is_same_v<decltype(expr), Array>); // nothing evaluated yet
+	REQUIRE(expr[2] == 3 + 6 * 9);
+
+	Array result = a + b * c - 1;
+	REQUIRE(result == Array{ 28, 41, 56 });
 
-	iterator begin()
+	SECTION("scalars on both sides")
 	{
-		return data_;
+		Array scaled = 2 * a + b / 2;
+		REQUIRE(scaled == Array{ 4, 6, 9 });
 	}
 
-	const_iterator begin() const
+	SECTION("aliasing - target used in the expression")
 	{
-		return data_;
+		result = result - a * 2 + result;
+		REQUIRE(result == Array{ 54, 78, 106 });
 	}
 
-	iterator end()
+	SECTION("assignment with a different size")
 	{
-		return data_ + size_;
+		Array target = { 1 };
+		target = a + b;
+		REQUIRE(target == Array{ 5, 7, 9 });
 	}
+}
 
-	const_iterator end() const
+TEST_CASE("BasicArray<T>")
+{
+	SECTION("trivially copyable elements")
 	{
-		return data_ + size_;
+		BasicArray<float> features = { 0.5f, 1.5f, 2.5f };
+		BasicArray<float> copy = features;
+		REQUIRE(copy == features);
+
+		BasicArray<double> scaled = BasicArray<double>(3, 2.0) * 0.5 + 1.0;
+		REQUIRE(scaled == BasicArray<double>{ 2.0, 2.0, 2.0 });
+
+		BasicArray<int64_t> big(2, int64_t{ 1 } << 40);
+		REQUIRE(big[1] == 1'099'511'627'776);
 	}
 
-	void reset(int value)
+	SECTION("non-trivial elements")
 	{
-		std::fill_n(data_, size_, value);
+		BasicArray<std::string> words = { "one", "two", "three" };
+		BasicArray<std::string> copy = words;
+		copy[0] = "ONE";
+		REQUIRE(words[0] == "one");
+
+		words = copy; // same size - element-wise assignment
+		REQUIRE(words[0] == "ONE");
+
+		std::vector<std::string> source = { std::string(100, 'a'), std::string(100, 'b') };
+		BasicArray<std::string> moved(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+		REQUIRE(moved[1] == std::string(100, 'b'));
+		REQUIRE(source.size() == 2); // moved-from strings are valid, their value is unspecified
 	}
 
-	size_t size() const
+	SECTION("move-only elements")
 	{
-		return this->size_;
+		std::vector<std::unique_ptr<int>> source;
+		source.push_back(std::make_unique<int>(1));
+		source.push_back(std::make_unique<int>(2));
+
+		BasicArray<std::unique_ptr<int>> moved(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+		REQUIRE(*moved[1] == 2);
+		REQUIRE(source[1] == nullptr); // a moved-from unique_ptr is guaranteed to be null
 	}
+}
+
+TEST_CASE("BasicArray - huge page storage")
+{
+	const size_t size = 3 * 1024 * 1024; // 12 MiB of ints
 
-	int& operator[](size_t index)
+	HugePageArray<int> big(size, 7);
+	REQUIRE(big[0] == 7);
+	REQUIRE(big[size - 1] == 7);
+
+#if defined(__linux__)
+	REQUIRE(reinterpret_cast<uintptr_t>(big.data()) % HugePageStorage<>::huge_page_size == 0);
+#endif
+
+	SECTION("parallel first touch")
 	{
-		return data_[index];
+		FirstTouchArray<int> numa(size, 42);
+		REQUIRE(std::all_of(numa.begin(), numa.end(), [](int x) { return x == 42; }));
 	}
 
-	const int& operator[](size_t index) const
+	SECTION("small arrays use the heap")
 	{
-		return data_[index];
+		HugePageArray<int> small = { 1, 2, 3 };
+		HugePageArray<int> copy = small;
+		REQUIRE(copy == Array{ 1, 2, 3 });
 	}
-};
 
-bool operator==(const Array& lhs, const Array& rhs)
-{	
-	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	SECTION("copy & move")
+	{
+		HugePageArray<int> copy = big;
+		REQUIRE(copy == big);
+
+		HugePageArray<int> target = std::move(copy);
+		REQUIRE(target[size / 2] == 7);
+	}
 }
 
-Array create_array()
+TEST_CASE("ArrayView")
 {
-	Array arr = { 1, 2, 3, 4, 5 };
+	Array arr = { 0, 1, 2, 3, 4, 5, 6, 7 };
 
-	for (auto& item : arr)
-		item *= 2;
+	ArrayView view = arr;
+	static_assert(std::is_same_v<decltype(view), ArrayView<int>>);
+	REQUIRE(view.data() == arr.data());
+	REQUIRE(view.size() == 8);
 
-	return arr;
-}
+	SECTION("subview")
+	{
+		std::vector expected = { 2, 3, 4 };
+		REQUIRE(view.subview(2, 3) == ArrayView(expected));
+	}
 
-TEST_CASE("Array")
-{
-	Array arr = create_array();
+	SECTION("strided slice")
+	{
+		auto odd = view.slice(1, 4, 2);
+		REQUIRE(odd.stride() == 2);
 
-	Array other = std::move(arr); // move constructor
+		std::vector expected = { 1, 3, 5, 7 };
+		REQUIRE(odd == ArrayView(expected));
 
-	Array another = { 1, 2, 3 };
+		auto every_other_odd = odd.slice(0, 2, 2);
+		REQUIRE(every_other_odd[1] == 5);
+	}
 
-	another = std::move(other); // move assignment
+	SECTION("reset through a view modifies the Array")
+	{
+		view.slice(0, 4, 2).reset(-1);
+		REQUIRE(arr == Array{ -1, 1, -1, 3, -1, 5, -1, 7 });
+	}
 
-	REQUIRE(another == Array{ 2, 4, 6, 8, 10 });
+	SECTION("read-only views")
+	{
+		const Array& carr = arr;
+		ArrayView<const int> cview = carr;
+		ArrayView<const int> from_mutable = view;
 
-	SECTION("move does not move")
+		REQUIRE(cview == from_mutable);
+		static_assert(!std::is_constructible_v<ArrayView<int>, const Array&>);
+	}
+}
+
+TEST_CASE("Array - expression templates vs temporaries", "[.benchmark]")
+{
+	const size_t size = 1'000'000;
+	const Array a(size, 1);
+	const Array b(size, 2);
+	const Array c(size, 3);
+	Array result(size);
+
+	BENCHMARK("materialized temporaries")
 	{
-		const Array carr = { 1, 2, 3 };
+		Array tmp = b; // b * c
+		for (size_t i = 0; i < size; ++i)
+			tmp[i] *= c[i];
 
-		Array target = std::move(carr);
+		Array sum = a; // a + tmp
+		for (size_t i = 0; i < size; ++i)
+			sum[i] += tmp[i];
 
-		REQUIRE(carr.size() == 3);
-	}
+		result = std::move(sum);
+		return result[0];
+	};
+
+	BENCHMARK("fused expression - new array")
+	{
+		Array fused = a + b * c; // one allocation, one pass
+		return fused[0];
+	};
+
+	BENCHMARK("fused expression - in place")
+	{
+		result = a + b * c; // no allocation, one pass
+		return result[0];
+	};
 }
 
-struct Data
+template <typename TArray>
+struct BasicData
 {
 	int id;
 	std::string name;
-	Array data;
+	TArray data;
 
 	//Data(int id, std::string n, Array d)
 	//	: id{ id }, name(std::move(n)), data(std::move(d))
 	//{
 	//}
 
-	template <typename TName, typename TArray>
-	Data(int id, TName&& name, TArray&& data)
-		: id{ id }, name(std::forward<TName>(name)), data(std::forward<TArray>(data))
+	template <typename TName, typename TArrayArg>
+	BasicData(int id, TName&& name, TArrayArg&& data)
+		: id{ id }, name(std::forward<TName>(name)), data(std::forward<TArrayArg>(data))
 	{
 	}
 
-	Data(const Data&) = default;
-	Data& operator=(const Data&) = default;
-	Data(Data&&) = default;
-	Data& operator=(Data&&) = default;
-	~Data() = default;
+	BasicData(const BasicData&) = default;
+	BasicData& operator=(const BasicData&) = default;
+	BasicData(BasicData&&) = default;
+	BasicData& operator=(BasicData&&) = default;
+	~BasicData() = default;
 
 	void print() const
 	{
-		std::cout << "Data(" << id << ", \"" << name << "\", [ ";
+		FastOutput::Writer out;
+		out << "Data(" << id << ", \"" << name << "\", [ ";
 		for (const auto& item : data)
-			std::cout << item << " ";
-		std::cout << "])\n";
+			out << item << " ";
+		out << "])\n";
 	}
 };
 
+using Data = BasicData<Array>;
+using SharedData = BasicData<SharedArray>; // copies share elements until modified
+
 TEST_CASE("Data - copy & move semantics")
 {
 	std::cout << "\n--------------------\n";
@@ -271,123 +594,578 @@ TEST_CASE("Data - copy & move semantics")
 	d1.print();
 }
 
-TEST_CASE("std::vector - move semantics")
+TEST_CASE("SharedData - copy on write")
 {
 	std::cout << "\n--------------------\n";
 
-	Array arr{ 1, 2, 3 };
+	SharedData d1{ 1, "d1", SharedArray{ 1, 2, 3 } };
 
-	std::vector<Array> vec;
+	SharedData d2 = d1; // no deep copy
+	REQUIRE(d1.data.use_count() == 2);
+	REQUIRE(std::as_const(d2).data.data() == std::as_const(d1).data.data());
 
-	vec.push_back(std::move(arr));
-	std::cout << "\n--------------------\n";
-	vec.push_back(Array{ 4, 5, 6 });
-	std::cout << "\n--------------------\n";
-	vec.emplace_back(std::initializer_list<int>{ 7, 8, 9 });
-	std::cout << "\n--------------------\n";
-	vec.emplace_back(std::initializer_list<int>{ 2, 1, 0 });
-	std::cout << "\n--------------------\n";
-	vec.push_back({ 56 });
-	std::cout << "\n--------------------\n";
+	SECTION("reading does not detach")
+	{
+		const SharedData& snapshot = d2;
+		REQUIRE(snapshot.data[2] == 3);
+		REQUIRE(d1.data.use_count() == 2);
+	}
 
-	Array target = std::move_if_noexcept(vec[0]);
-}
+	SECTION("writing detaches")
+	{
+		d2.data[0] = 42;
 
-struct Gadget
-{
-	std::string name;
-};
+		REQUIRE(d1.data.use_count() == 1);
+		REQUIRE(d1.data == SharedArray{ 1, 2, 3 });
+		REQUIRE(d2.data == SharedArray{ 42, 2, 3 });
+	}
 
-void have_fun(Gadget& g)
-{
-	puts(__FUNCSIG__);
-	std::cout << "Having fun with " << g.name << "\n";
-}
+	SECTION("reset detaches")
+	{
+		d2.data.reset(0);
 
-void have_fun(const Gadget& g)
-{
-	puts(__FUNCSIG__);
-	std::cout << "Having fun with " << g.name << "\n";
+		REQUIRE(d1.data == SharedArray{ 1, 2, 3 });
+		REQUIRE(d2.data == SharedArray{ 0, 0, 0 });
+	}
 }
 
-void have_fun(Gadget&& g)
+TEST_CASE("PackedData - single allocation record")
 {
-	puts(__FUNCSIG__);
-	std::cout << "Having fun with " << g.name << "\n";
-}
-
-//void use(Gadget& g)
-//{
-//	puts(__FUNCSIG__);
-//	have_fun(g);
-//}
-//
-//void use(const Gadget& g)
-//{
-//	puts(__FUNCSIG__);
-//	have_fun(g);
-//}
-//
-//
-//void use(Gadget&& g)
-//{
-//	puts(__FUNCSIG__);
-//	have_fun(std::move(g));
-//}
+	std::cout << "\n--------------------\n";
 
+	std::string name = "packed";
+	PackedData d1{ 1, name, Array{ 1, 2, 3 } };
+	d1.print();
 
+	REQUIRE(d1.id() == 1);
+	REQUIRE(d1.name() == "packed");
+	REQUIRE(d1.data() == ArrayView<const int>(std::as_const(d1).data()));
+	REQUIRE(d1.data()[2] == 3);
+	REQUIRE(sizeof(PackedData) == sizeof(void*));
 
-template <typename T>
-void use(T&& g)
-{
-	puts(__FUNCSIG__);
-	have_fun(std::forward<T>(g));
-}
+	SECTION("name follows items in the same block")
+	{
+		REQUIRE(d1.name().data() == reinterpret_cast<const char*>(d1.data().data() + 3));
+	}
 
-TEST_CASE("perfect forwarding")
-{
-	Gadget g{ "g" };
-	const Gadget cg{ "cg" };
+	SECTION("empty name")
+	{
+		PackedData unnamed{ 2, std::string_view{}, Array{ 4 } }; // view with a null data()
 
-	use(g);
-	use(cg);
-	use(Gadget{ "temp gadget" });
-}
+		REQUIRE(unnamed.name().empty());
+		REQUIRE(unnamed.data()[0] == 4);
+	}
 
-TEST_CASE("auto")
-{
-	auto&& aref1 = 42; // int&&
+	SECTION("copy is deep")
+	{
+		PackedData d2 = d1;
+		d2.data()[0] = 42;
 
-	int x = 665;
-	auto&& aref2 = x;  // int&
-}
+		REQUIRE(d2.name() == "packed");
+		REQUIRE(d1.data()[0] == 1);
+	}
 
-TEST_CASE("perfect forwarding - use cases")
-{
-	std::vector<Data> vec;
+	SECTION("move leaves an empty record")
+	{
+		PackedData d3 = std::move(d1);
 
-	vec.emplace_back(1, "item1", Array{ 1, 2, 3 });
-	vec.emplace_back(2, "item2", Array{ 4, 5, 6 });
+		REQUIRE(d3.data()[1] == 2);
 
-	std::string text = "item3";
-	std::unique_ptr<Data> ptr1 = std::make_unique<Data>(3, text, Array{ 7, 7, 8 });
-	ptr1->print();	
+		// documented moved-from state of PackedData (the block is taken, no std::string is involved)
+		REQUIRE(d1.id() == 0);
+		REQUIRE(d1.name().empty());
+		REQUIRE(d1.data().empty());
+	}
 }
 
-
-using Row = Array;
-
-struct DataSet
+TEST_CASE("PackedData - iteration benchmark", "[.benchmark]")
 {
-	std::vector<Row> rows;
+	ArrayTracing::Disable no_tracing;
 
-	template <typename TRow>
-	void add(TRow&& r)
+	std::vector<Data> data;
+	std::vector<PackedData> packed;
+	for (int i = 0; i < 100'000; ++i)
 	{
-		rows.emplace_back(std::forward<TRow>(r));
+		Array items(8, i);
+		std::string name = "record #" + std::to_string(i) + " with a name too long for SSO";
+		data.emplace_back(i, name, items);
+		packed.emplace_back(i, name, items);
 	}
+
+	BENCHMARK("std::vector<Data>")
+	{
+		size_t total = 0;
+		for (const auto& d : data)
+			total += d.name.size() + static_cast<size_t>(std::accumulate(d.data.begin(), d.data.end(), 0));
+		return total;
+	};
+
+	BENCHMARK("std::vector<PackedData>")
+	{
+		size_t total = 0;
+		for (const auto& d : packed)
+			total += d.name().size() + static_cast<size_t>(std::accumulate(d.data().begin(), d.data().end(), 0));
+		return total;
+	};
+}
+
+namespace
+{
+	// redirects std::cout for the lifetime of the object
+	class CoutRedirect
+	{
+		std::streambuf* original_;
+
+	public:
+		explicit CoutRedirect(std::streambuf* target) : original_{ std::cout.rdbuf(target) }
+		{
+		}
+
+		~CoutRedirect()
+		{
+			std::cout.rdbuf(original_);
+		}
+	};
+
+	struct NullBuffer : std::streambuf
+	{
+		int overflow(int c) override
+		{
+			return c;
+		}
+
+		std::streamsize xsputn(const char*, std::streamsize count) override
+		{
+			return count;
+		}
+	};
+}
+
+TEST_CASE("FastOutput - formatting")
+{
+	std::ostringstream captured;
+	CoutRedirect redirect{ captured.rdbuf() };
+
+	SECTION("same text as iostreams")
+	{
+		std::ostringstream expected;
+		const int* ptr = reinterpret_cast<const int*>(0x1234);
+
+		FastOutput::Writer{} << "int: " << -42 << ", size_t: " << size_t{ 18'446'744'073'709'551'615u } << ", char: " << 'x'
+							 << ", bool: " << true << ", string: " << std::string("text") << ", ptr: " << ptr << ", double: " << 0.5;
+		expected << "int: " << -42 << ", size_t: " << size_t{ 18'446'744'073'709'551'615u } << ", char: " << 'x'
+				 << ", bool: " << true << ", string: " << std::string("text") << ", ptr: " << ptr << ", double: " << 0.5;
+
+		REQUIRE(captured.str() == expected.str());
+	}
+
+	SECTION("char-like integers are characters, long double as iostreams")
+	{
+		std::ostringstream expected;
+
+		FastOutput::Writer{} << static_cast<signed char>('a') << static_cast<unsigned char>('b') << int8_t{ 'c' } << uint8_t{ 'd' } << ' ' << 1.5L;
+		expected << static_cast<signed char>('a') << static_cast<unsigned char>('b') << int8_t{ 'c' } << uint8_t{ 'd' } << ' ' << 1.5L;
+
+		REQUIRE(captured.str() == expected.str());
+		REQUIRE(captured.str() == "abcd 1.5");
+	}
+
+	SECTION("doubles with 6 significant digits as iostreams")
+	{
+		std::ostringstream expected;
+
+		for (double value : { 1.0 / 3, 2.0 / 3 * 1e10, 123456.7, 0.0001234567, -1e-5, 100.0, 1e100 })
+		{
+			FastOutput::Writer{} << value << ' ';
+			expected << value << ' ';
+		}
+
+		REQUIRE(captured.str() == expected.str());
+		REQUIRE(captured.str().starts_with("0.333333 6.66667e+09 123457 "));
+	}
+
+	SECTION("endl writes immediately - also inside a Batch")
+	{
+		FastOutput::Batch batch;
+		FastOutput::Writer{} << "line" << FastOutput::endl;
+		REQUIRE(captured.str() == "line\n");
+	}
+
+	SECTION("other types go through operator<<")
+	{
+		FastOutput::Writer{} << "[" << std::filesystem::path("a") << "]";
+		REQUIRE(captured.str() == "[\"a\"]");
+	}
+
+	SECTION("Batch defers the write until the end of the scope")
+	{
+		{
+			FastOutput::Batch batch;
+			FastOutput::Writer{} << 1 << '\n';
+			FastOutput::Writer{} << 2 << '\n';
+			REQUIRE(captured.str().empty());
+		}
+		REQUIRE(captured.str() == "1\n2\n");
+	}
+
+	SECTION("Data::print")
+	{
+		ArrayTracing::Disable no_tracing;
+
+		Data{ 7, "seven", Array{ 1, 2, 3 } }.print();
+		REQUIRE(captured.str() == "Data(7, \"seven\", [ 1 2 3 ])\n");
+	}
+}
+
+TEST_CASE("FastOutput - benchmark", "[.benchmark]")
+{
+	ArrayTracing::Disable no_tracing;
+
+	NullBuffer null_buffer;
+	CoutRedirect redirect{ &null_buffer };
+
+	Data data{ 1, "large", Array(100'000, 665) };
+	std::iota(data.data.begin(), data.data.end(), -50'000);
+
+	BENCHMARK("iostreams - std::cout << item")
+	{
+		std::cout << "Data(" << data.id << ", \"" << data.name << "\", [ ";
+		for (const auto& item : data.data)
+			std::cout << item << " ";
+		std::cout << "])\n";
+	};
+
+	BENCHMARK("Data::print - to_chars & one write per 64 KiB")
+	{
+		FastOutput::Batch batch;
+		data.print();
+	};
+}
+
+TEST_CASE("EventLog - lifetime tracing")
+{
+	struct Recorded
+	{
+		uint32_t thread_id;
+		EventLog::Event event;
+	};
+
+	std::vector<Recorded> events; // the sink runs on the drainer thread only
+	std::ostringstream captured;
+	CoutRedirect redirect{ captured.rdbuf() };
+
+	EventLog::logger().start([&events](uint32_t thread_id, const EventLog::Event& event) { events.push_back({ thread_id, event }); });
+
+	SECTION("Array special members are recorded instead of printed")
+	{
+		{
+			Array a{ 1, 2, 3 };
+			Array b = a;
+			Array c = std::move(a);
+		}
+		EventLog::logger().stop();
+
+		REQUIRE(captured.str().empty());
+
+		std::vector<EventLog::EventType> types;
+		for (const auto& r : events)
+			types.push_back(r.event.type);
+
+		using enum EventLog::EventType;
+		REQUIRE(types == std::vector{ Construct, CopyConstruct, MoveConstruct, Destroy, Destroy, Destroy });
+		REQUIRE(events[1].event.address == events[4].event.address); // b
+		REQUIRE(std::is_sorted(events.begin(), events.end(), [](const auto& x, const auto& y) { return x.event.timestamp < y.event.timestamp; }));
+	}
+
+	SECTION("SharedArray detach is recorded as a copy")
+	{
+		{
+			SharedArray a{ 1, 2, 3 };
+			SharedArray b = a;
+			b[0] = 42;
+		}
+		EventLog::logger().stop();
+
+		REQUIRE(captured.str().empty());
+		REQUIRE(events.size() == 3);
+		REQUIRE(events[2].event.type == EventLog::EventType::CopyConstruct);
+		REQUIRE(std::string_view(events[2].event.label) == "SharedArray - detach (deep copy)");
+	}
+
+	SECTION("events of each thread are kept in order")
+	{
+		const int no_of_threads = 4;
+		const int events_per_thread = 2000;
+
+		std::vector<int> objects(no_of_threads);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < no_of_threads; ++t)
+			threads.emplace_back([&, t] {
+				for (int i = 0; i < events_per_thread; ++i)
+				{
+					EventLog::record(EventLog::EventType::Call, &objects[t]);
+					if (i % 256 == 0)
+						std::this_thread::yield();
+				}
+			});
+
+		for (auto& thd : threads)
+			thd.join();
+		EventLog::logger().stop();
+
+		const auto dropped = EventLog::logger().dropped();
+		REQUIRE(events.size() + dropped == no_of_threads * events_per_thread);
+
+		std::map<uint32_t, std::vector<Recorded>> by_thread;
+		for (const auto& r : events)
+			by_thread[r.thread_id].push_back(r);
+
+		for (const auto& [thread_id, recorded] : by_thread)
+		{
+			REQUIRE(std::all_of(recorded.begin(), recorded.end(), [&](const Recorded& r) { return r.event.address == recorded.front().event.address; }));
+			REQUIRE(std::is_sorted(recorded.begin(), recorded.end(), [](const auto& x, const auto& y) { return x.event.timestamp < y.event.timestamp; }));
+		}
+	}
+
+	SECTION("sink may create traced objects & flush")
+	{
+		EventLog::logger().start([&events](uint32_t thread_id, const EventLog::Event& event) {
+			events.push_back({ thread_id, event });
+			if (event.type == EventLog::EventType::Call)
+			{
+				Array temp{ 1 }; // recorded from the sink - drained in the next pass
+				EventLog::logger().flush(); // returns at once
+			}
+		});
+
+		EventLog::trace_call("void f()");
+		EventLog::logger().flush();
+		EventLog::logger().stop();
+
+		using enum EventLog::EventType;
+		REQUIRE(events.size() == 3);
+		REQUIRE(events[0].event.type == Call);
+		REQUIRE(events[1].event.type == Construct);
+		REQUIRE(events[2].event.type == Destroy);
+	}
+
+	SECTION("nothing is recorded after stop")
+	{
+		EventLog::logger().stop();
+
+		REQUIRE_FALSE(EventLog::record(EventLog::EventType::Call, nullptr));
+		EventLog::trace_call("void f()");
+		REQUIRE(events.empty());
+		REQUIRE(captured.str() == "void f()\n");
+	}
+
+	EventLog::logger().stop();
+}
+
+TEST_CASE("EventLog - Chrome trace export")
+{
+	SECTION("copies & moves as trace events")
+	{
+		std::ostringstream json;
+		{
+			EventLog::ChromeTrace trace{ json };
+			EventLog::logger().start(trace.sink());
+
+			Array a{ 1, 2, 3 };
+			Array b = a;
+			Array c = std::move(a);
+
+			EventLog::logger().stop();
+		}
+
+		const std::string text = json.str();
+		auto count = [&text](const std::string& pattern) {
+			size_t n = 0;
+			for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+				++n;
+			return n;
+		};
+
+		REQUIRE(text.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+		REQUIRE(text.ends_with("\n]}\n"));
+		REQUIRE(count("\"ph\":\"M\"") == 1); // one thread
+		REQUIRE(count("\"ph\":\"i\"") == 3); // constructions
+		REQUIRE(count("\"name\":\"Array(const Array& - copy constructor)\",\"cat\":\"copy\"") == 1);
+		REQUIRE(count("\"cat\":\"move\"") == 1);
+		REQUIRE(count("\"cat\":\"destroy\"") == 0); // still alive when recording stopped
+		REQUIRE(count("{") == count("}"));
+	}
+
+	SECTION("labels are escaped")
+	{
+		std::ostringstream json;
+		EventLog::ChromeTrace trace{ json };
+		trace.add(7, EventLog::Event{ 1'234'567, nullptr, "say \"hi\"\n", EventLog::EventType::Call });
+		trace.finish();
+
+		REQUIRE(json.str().find("{\"ph\":\"i\",\"s\":\"t\",\"name\":\"say \\\"hi\\\"\\u000a\",\"cat\":\"call\",\"ts\":1234.567,\"pid\":1,\"tid\":7,\"args\":{\"address\":\"0x0\"}}")
+				!= std::string::npos);
+	}
+
+	SECTION("trace file")
+	{
+		const std::string path = unique_temp_path("lifetime_trace", ".json");
+		{
+			EventLog::ChromeTraceFile trace_file{ path };
+
+			std::vector<Array> vec;
+			vec.push_back(Array{ 1, 2 });
+			vec.push_back(Array{ 3, 4 }); // reallocation
+		}
+
+		std::ifstream in{ path };
+		const std::string text{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+		REQUIRE(text.find("\"cat\":\"move\"") != std::string::npos);
+		REQUIRE(text.find("\"cat\":\"destroy\"") != std::string::npos);
+		REQUIRE(text.ends_with("]}\n"));
+
+		in.close();
+		std::filesystem::remove(path);
+	}
+
+	SECTION("file that can not be created")
+	{
+		const std::string path = (std::filesystem::path(unique_temp_path("missing_directory", "")) / "trace.json").string();
+
+		REQUIRE_THROWS_AS(EventLog::ChromeTraceFile{ path }, std::runtime_error);
+		REQUIRE_FALSE(EventLog::is_recording());
+	}
+}
+
+TEST_CASE("EventLog - benchmark", "[.benchmark]")
+{
+	NullBuffer null_buffer;
+	CoutRedirect redirect{ &null_buffer };
+
+	BENCHMARK("Array copy & move - text tracing")
+	{
+		Array a(16);
+		Array b = a;
+		return Array(std::move(b)).size();
+	};
+
+	size_t recorded = 0;
+	EventLog::logger().start([&recorded](uint32_t, const EventLog::Event&) { ++recorded; });
+
+	BENCHMARK("Array copy & move - event log")
+	{
+		Array a(16);
+		Array b = a;
+		return Array(std::move(b)).size();
+	};
+
+	EventLog::logger().stop();
+}
+
+TEST_CASE("std::vector - move semantics")
+{
+	std::cout << "\n--------------------\n";
+
+	Array arr{ 1, 2, 3 };
+
+	std::vector<Array> vec;
+
+	vec.push_back(std::move(arr));
+	std::cout << "\n--------------------\n";
+	vec.push_back(Array{ 4, 5, 6 });
+	std::cout << "\n--------------------\n";
+	vec.emplace_back(std::initializer_list<int>{ 7, 8, 9 });
+	std::cout << "\n--------------------\n";
+	vec.emplace_back(std::initializer_list<int>{ 2, 1, 0 });
+	std::cout << "\n--------------------\n";
+	vec.push_back({ 56 });
+	std::cout << "\n--------------------\n";
+
+	Array target = std::move_if_noexcept(vec[0]);
+}
+
+struct Gadget
+{
+	std::string name;
 };
 
+void have_fun(Gadget& g)
+{
+	EventLog::trace_call(__FUNCSIG__);
+	std::cout << "Having fun with " << g.name << "\n";
+}
+
+void have_fun(const Gadget& g)
+{
+	EventLog::trace_call(__FUNCSIG__);
+	std::cout << "Having fun with " << g.name << "\n";
+}
+
+void have_fun(Gadget&& g)
+{
+	EventLog::trace_call(__FUNCSIG__);
+	std::cout << "Having fun with " << g.name << "\n";
+}
+
+//void use(Gadget& g)
+//{
+//	puts(__FUNCSIG__);
+//	have_fun(g);
+//}
+//
+//void use(const Gadget& g)
+//{
+//	puts(__FUNCSIG__);
+//	have_fun(g);
+//}
+//
+//
+//void use(Gadget&& g)
+//{
+//	puts(__FUNCSIG__);
+//	have_fun(std::move(g));
+//}
+
+
+
+template <typename T>
+void use(T&& g)
+{
+	EventLog::trace_call(__FUNCSIG__);
+	have_fun(std::forward<T>(g));
+}
+
+TEST_CASE("perfect forwarding")
+{
+	Gadget g{ "g" };
+	const Gadget cg{ "cg" };
+
+	use(g);
+	use(cg);
+	use(Gadget{ "temp gadget" });
+}
+
+TEST_CASE("auto")
+{
+	auto&& aref1 = 42; // int&&
+
+	int x = 665;
+	auto&& aref2 = x;  // int&
+}
+
+TEST_CASE("perfect forwarding - use cases")
+{
+	std::vector<Data> vec;
+
+	vec.emplace_back(1, "item1", Array{ 1, 2, 3 });
+	vec.emplace_back(2, "item2", Array{ 4, 5, 6 });
+
+	std::string text = "item3";
+	std::unique_ptr<Data> ptr1 = std::make_unique<Data>(3, text, Array{ 7, 7, 8 });
+	ptr1->print();	
+}
+
+
 TEST_CASE("DataSet")
 {
 	std::cout << "\n==============================\n";
@@ -395,4 +1173,638 @@ TEST_CASE("DataSet")
 	DataSet ds;
 
 	ds.add(Array{ 1, 2, 3 });
-}
\ No newline at end of file
+}
+
+TEST_CASE("DataSet - binary file")
+{
+	const std::string path = unique_temp_path("dataset_test", ".bin");
+
+	DataSet ds;
+	ds.add(Array{ 1, 2, 3 });
+	ds.add(Array{});
+	ds.add(Array{ 4, 5 });
+
+	DataSetFile::save(ds, path);
+
+	{
+		MappedDataSet mapped{ path };
+
+		REQUIRE(mapped.size() == 3);
+		REQUIRE(mapped[0] == ArrayView<const int>(ds.rows[0]));
+		REQUIRE(mapped[1].empty());
+		REQUIRE(mapped[2][1] == 5);
+
+		DataSet copy = mapped.to_dataset();
+		REQUIRE(copy.rows[2] == ds.rows[2]);
+	}
+
+	SECTION("invalid file")
+	{
+		std::ofstream(path, std::ios::binary) << "not a dataset file";
+		REQUIRE_THROWS_AS(MappedDataSet{ path }, std::runtime_error);
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("DataSet - csv loader")
+{
+	const std::string text = "1,2,3\n4, 5 ,6\r\n\n7\n-8,9\n100,200,300,400,500,600,700";
+
+	Csv::Options options;
+	options.chunk_size = 8; // lines cross chunk boundaries, the last one is longer than the buffer
+
+	std::istringstream in(text);
+	DataSet ds = Csv::load(in, options);
+
+	REQUIRE(ds.rows.size() == 5);
+	REQUIRE(ds.rows[0] == Array{ 1, 2, 3 });
+	REQUIRE(ds.rows[1] == Array{ 4, 5, 6 });
+	REQUIRE(ds.rows[2] == Array{ 7 });
+	REQUIRE(ds.rows[3] == Array{ -8, 9 });
+	REQUIRE(ds.rows[4].size() == 7);
+
+	SECTION("parallel parsing keeps the order of rows")
+	{
+		ArrayTracing::Disable no_tracing;
+
+		std::string many;
+		for (int i = 0; i < 1000; ++i)
+			many += std::to_string(i) + ";" + std::to_string(-i) + "\n";
+
+		Csv::Options parallel;
+		parallel.delimiter = ';';
+		parallel.chunk_size = 4096;
+		parallel.threads = 4;
+
+		std::istringstream many_in(many);
+		DataSet result = Csv::load(many_in, parallel);
+
+		REQUIRE(result.rows.size() == 1000);
+
+		bool in_order = true;
+		for (int i = 0; i < 1000; ++i)
+			in_order = in_order && result.rows[i][0] == i && result.rows[i][1] == -i;
+		REQUIRE(in_order);
+	}
+
+	SECTION("invalid input")
+	{
+		std::istringstream bad("1,2\n3,x,4\n");
+		REQUIRE_THROWS_AS(Csv::load(bad), std::runtime_error);
+	}
+}
+
+TEST_CASE("DataSet - streaming rows with a generator")
+{
+	ArrayTracing::Disable no_tracing;
+
+	DataSet ds;
+	ds.add(Array{ 1, 2, 3 });
+	ds.add(Array{});
+	ds.add(Array{ 4, 5 });
+
+	auto sum_of = [](Generator<RowView> rows) {
+		int total = 0;
+		for (RowView row : rows)
+			total = std::accumulate(row.begin(), row.end(), total);
+		return total;
+	};
+
+	SECTION("from memory - rows are not copied")
+	{
+		std::vector<const int*> seen;
+		for (RowView row : stream_rows(ds))
+			seen.push_back(row.data());
+
+		REQUIRE(seen == std::vector<const int*>{ ds.rows[0].data(), ds.rows[1].data(), ds.rows[2].data() });
+		REQUIRE(sum_of(stream_rows(ds)) == 15);
+	}
+
+	SECTION("from a mapped file")
+	{
+		const std::string path = unique_temp_path("dataset_stream_test", ".bin");
+		DataSetFile::save(ds, path);
+
+		{
+			MappedDataSet mapped{ path };
+			REQUIRE(sum_of(stream_rows(mapped)) == 15);
+		}
+
+		std::filesystem::remove(path);
+	}
+
+	SECTION("from csv text - rows are parsed on demand")
+	{
+		std::istringstream in("1,2,3\n\n4,5\n6,x\n");
+
+		Csv::Options options;
+		options.chunk_size = 4;
+
+		auto rows = stream_csv_rows(in, options);
+		auto it = rows.begin();
+		REQUIRE(*it == ArrayView<const int>(ds.rows[0]));
+		++it;
+		REQUIRE(*it == ArrayView<const int>(ds.rows[2]));
+		REQUIRE_THROWS_AS(++it, std::runtime_error); // invalid line is reached only now
+	}
+}
+
+TEST_CASE("DataSet - hash index & group by")
+{
+	ArrayTracing::Disable no_tracing;
+
+	DataSet ds;
+	for (int i = 0; i < 10'000; ++i)
+		ds.add(Array{ i % 37, i, -i });
+	ds.add(Array{ 5 }); // too short for value column
+
+	SECTION("hash index")
+	{
+		HashIndex index{ ds, 0 };
+		REQUIRE(index.key_count() == 37);
+
+		auto rows = index.find(5);
+		REQUIRE(rows.size() == 10'000 / 37 + 1 + 1); // + short row
+		REQUIRE(std::all_of(rows.begin(), rows.end(), [&ds](size_t i) { return ds.rows[i][0] == 5; }));
+		REQUIRE(index.find(1'000).empty());
+	}
+
+	SECTION("group by")
+	{
+		std::map<int, Aggregate> expected;
+		for (const auto& row : ds.rows)
+			if (row.size() > 1)
+				expected[row[0]].add(row[1]);
+
+		for (size_t threads : { 1, 4 })
+		{
+			auto groups = group_by(ds, 0, 1, threads);
+			REQUIRE(groups.size() == expected.size());
+
+			bool same = true;
+			for (const auto& [key, aggregate] : groups)
+			{
+				const Aggregate& e = expected.at(key);
+				same = same && aggregate.count == e.count && aggregate.sum == e.sum && aggregate.min == e.min && aggregate.max == e.max;
+			}
+			REQUIRE(same);
+		}
+	}
+}
+
+TEST_CASE("CompressedDataSet")
+{
+	ArrayTracing::Disable no_tracing;
+
+	DataSet ds;
+	ds.add(Array{});
+	ds.add(Array{ 42 });
+	ds.add(Array{ 7, 7, 7, 7, 7 });
+	ds.add(Array{ std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 0, -1, std::numeric_limits<int>::max(), std::numeric_limits<int>::min(), 1 });
+
+	Array sorted(1'000);
+	for (int i = 0; i < 1'000; ++i)
+		sorted[i] = 1'000'000 + i * 10 + i % 3;
+	ds.add(sorted);
+
+	Array small_range(1'003);
+	for (size_t i = 0; i < small_range.size(); ++i)
+		small_range[i] = -500 + static_cast<int>(i * 7919 % 100);
+	ds.add(small_range);
+
+	CompressedDataSet cds{ ds };
+
+	SECTION("rows are decoded to the original values")
+	{
+		REQUIRE(cds.size() == ds.rows.size());
+		for (size_t i = 0; i < ds.rows.size(); ++i)
+			REQUIRE(cds[i] == ds.rows[i]);
+
+		REQUIRE(cds.to_dataset().rows == ds.rows);
+	}
+
+	SECTION("encoding & bit width are chosen per row")
+	{
+		REQUIRE(cds.bit_width(2) == 0);
+		REQUIRE(cds.bit_width(3) == 32);
+		REQUIRE(cds.encoding(4) == CompressedDataSet::Encoding::Delta);
+		REQUIRE(cds.bit_width(4) == 2); // deltas 38..41
+		REQUIRE(cds.encoding(5) == CompressedDataSet::Encoding::FrameOfReference);
+		REQUIRE(cds.bit_width(5) == 7);
+	}
+
+	SECTION("scan decodes into a reused buffer")
+	{
+		int64_t expected = 0, total = 0;
+		for (const auto& row : ds.rows)
+			expected = std::accumulate(row.begin(), row.end(), expected);
+
+		cds.for_each([&total](size_t, ArrayView<const int> row) { total = std::accumulate(row.begin(), row.end(), total); });
+
+		REQUIRE(total == expected);
+	}
+
+	SECTION("at least 4x smaller than raw values")
+	{
+		CompressedDataSet large;
+		for (int i = 0; i < 100; ++i)
+			large.add(small_range);
+		large.shrink_to_fit();
+
+		REQUIRE(large.memory_usage() * 4 <= large.value_count() * sizeof(int));
+	}
+
+	SECTION("row metadata does not dominate short rows")
+	{
+		CompressedDataSet mixed; // lengths 1..64 - half of the rows are shorter than 32 values
+		for (size_t length = 1; length <= 64; ++length)
+		{
+			for (int i = 0; i < 10; ++i)
+			{
+				Array row(length);
+				for (size_t j = 0; j < length; ++j)
+					row[j] = static_cast<int>((i + j * 5) % 16); // 4 bits per value
+				mixed.add(row);
+			}
+		}
+		mixed.shrink_to_fit();
+
+		REQUIRE(mixed.size() == 640);
+		REQUIRE(mixed.memory_usage() * 3 <= mixed.value_count() * sizeof(int));
+	}
+}
+
+TEST_CASE("CompressedDataSet - scan benchmark", "[.benchmark]")
+{
+	ArrayTracing::Disable no_tracing;
+
+	DataSet ds;
+	for (int i = 0; i < 1'000; ++i)
+	{
+		Array row(1'000);
+		for (int j = 0; j < 1'000; ++j)
+			row[j] = (i * 31 + j * 17) % 1'000;
+		ds.add(std::move(row));
+	}
+
+	CompressedDataSet cds{ ds };
+	std::cout << "raw: " << cds.value_count() * sizeof(int) << " bytes, compressed: " << cds.memory_usage() << " bytes\n";
+
+	BENCHMARK("DataSet - sum")
+	{
+		int64_t total = 0;
+		for (const auto& row : ds.rows)
+			total = std::accumulate(row.begin(), row.end(), total);
+		return total;
+	};
+
+	BENCHMARK("CompressedDataSet - decode & sum")
+	{
+		int64_t total = 0;
+		cds.for_each([&total](size_t, ArrayView<const int> row) { total = std::accumulate(row.begin(), row.end(), total); });
+		return total;
+	};
+}
+
+TEST_CASE("DataSet - sort, merge & top-k")
+{
+	ArrayTracing::Disable no_tracing;
+
+	std::mt19937 rnd{ 665 };
+	std::uniform_int_distribution<int> keys{ -1'000, 1'000 };
+
+	DataSet ds;
+	for (int i = 0; i < 5'000; ++i)
+		ds.add(Array{ i, keys(rnd) });
+	ds.add(Array{ -1 }); // no key
+	ds.add(Array{ std::numeric_limits<int>::min(), std::numeric_limits<int>::min() });
+	ds.add(Array{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max() });
+
+	auto expected_order = [&ds](SortOrder order) {
+		std::vector<size_t> rows(ds.rows.size());
+		std::iota(rows.begin(), rows.end(), 0);
+		std::stable_sort(rows.begin(), rows.end(), [&ds, order](size_t a, size_t b) {
+			if (ds.rows[b].size() < 2)
+				return ds.rows[a].size() >= 2;
+			if (ds.rows[a].size() < 2)
+				return false;
+			return order == SortOrder::Ascending ? ds.rows[a][1] < ds.rows[b][1] : ds.rows[a][1] > ds.rows[b][1];
+		});
+		return rows;
+	};
+
+	SECTION("sort order is stable")
+	{
+		REQUIRE(sort_order(ds, 1) == expected_order(SortOrder::Ascending));
+		REQUIRE(sort_order(ds, 1, SortOrder::Descending) == expected_order(SortOrder::Descending));
+	}
+
+	SECTION("parallel merge sort")
+	{
+		for (size_t threads : { 2, 3, 8 })
+			REQUIRE(parallel_sort_order(ds, 1, threads) == expected_order(SortOrder::Ascending));
+	}
+
+	SECTION("sort_by_column moves every row once")
+	{
+		std::vector<const int*> buffers;
+		for (size_t i : expected_order(SortOrder::Ascending))
+			buffers.push_back(ds.rows[i].data());
+
+		sort_by_column(ds, 1);
+
+		std::vector<const int*> sorted_buffers;
+		for (const auto& row : ds.rows)
+			sorted_buffers.push_back(row.data());
+
+		REQUIRE(sorted_buffers == buffers);
+	}
+
+	SECTION("top-k")
+	{
+		auto expected = expected_order(SortOrder::Descending);
+		expected.resize(10);
+
+		REQUIRE(top_k(ds, 1, 10) == expected);
+		REQUIRE(top_k(ds, 1, 1, SortOrder::Ascending) == std::vector<size_t>{ 5'001 });
+		REQUIRE(top_k(ds, 1, 100'000).size() == ds.rows.size() - 1);
+	}
+
+	SECTION("merge")
+	{
+		DataSet lhs, rhs;
+		for (int i = 0; i < 10; ++i)
+			(i % 3 == 0 ? lhs : rhs).add(Array{ i * 2, i });
+
+		DataSet merged = merge_by_column(std::move(lhs), std::move(rhs), 0);
+
+		REQUIRE(merged.rows.size() == 10);
+		REQUIRE(std::is_sorted(merged.rows.begin(), merged.rows.end(), [](const Row& a, const Row& b) { return a[0] < b[0]; }));
+		REQUIRE(lhs.rows.empty());
+	}
+}
+
+TEST_CASE("DataSet - sort benchmark", "[.benchmark]")
+{
+	ArrayTracing::Disable no_tracing;
+
+	std::mt19937 rnd{ 665 };
+	DataSet ds;
+	for (int i = 0; i < 1'000'000; ++i)
+		ds.add(Array{ i, static_cast<int>(rnd()) });
+
+	BENCHMARK("std::stable_sort of rows")
+	{
+		DataSet copy = ds;
+		std::stable_sort(copy.rows.begin(), copy.rows.end(), [](const Row& a, const Row& b) { return a[1] < b[1]; });
+		return copy.rows.size();
+	};
+
+	BENCHMARK("sort_by_column - radix sort & one permutation pass")
+	{
+		DataSet copy = ds;
+		sort_by_column(copy, 1);
+		return copy.rows.size();
+	};
+
+	const size_t no_of_threads = std::max(2u, std::thread::hardware_concurrency());
+	BENCHMARK("sort_by_column - " + std::to_string(no_of_threads) + " threads")
+	{
+		DataSet copy = ds;
+		sort_by_column(copy, 1, SortOrder::Ascending, no_of_threads);
+		return copy.rows.size();
+	};
+
+	BENCHMARK("top_k(100)")
+	{
+		return top_k(ds, 1, 100);
+	};
+}
+
+TEST_CASE("DataSet - lazy query")
+{
+	ArrayTracing::Disable no_tracing;
+
+	DataSet ds;
+	for (int i = 0; i < 1'000; ++i)
+		ds.add(Array{ i, i % 10 });
+
+	SECTION("filter, map & reduce in one pass")
+	{
+		auto total = ds.view()
+						 .filter([](const Row& row) { return row[1] == 3; })
+						 .map([](const Row& row) { return int64_t{ row[0] } * 2; })
+						 .filter([](int64_t value) { return value > 100; })
+						 .reduce(int64_t{ 0 }, std::plus<>{});
+
+		int64_t expected = 0;
+		for (const auto& row : ds.rows)
+			if (row[1] == 3 && row[0] * 2 > 100)
+				expected += row[0] * 2;
+
+		REQUIRE(total == expected);
+	}
+
+	SECTION("nothing runs until reduce")
+	{
+		int calls = 0;
+		auto query = ds.view().map([&calls](const Row& row) { ++calls; return row[0]; });
+
+		REQUIRE(calls == 0);
+		REQUIRE(query.count() == 1'000);
+		REQUIRE(calls == 1'000);
+	}
+
+	SECTION("rows are not copied")
+	{
+		std::vector<const int*> seen;
+		ds.view().filter([](const Row& row) { return row[0] < 3; }).for_each([&seen](const Row& row) { seen.push_back(row.data()); });
+
+		REQUIRE(seen == std::vector<const int*>{ ds.rows[0].data(), ds.rows[1].data(), ds.rows[2].data() });
+	}
+
+	SECTION("parallel reduce")
+	{
+		auto query = ds.view().map([](const Row& row) { return int64_t{ row[0] }; });
+
+		for (size_t threads : { 1, 2, 7 })
+		{
+			REQUIRE(query.reduce(int64_t{ 0 }, std::plus<>{}, threads) == 999 * 1'000 / 2);
+
+			ThreadPool pool{ threads };
+			REQUIRE(query.reduce(int64_t{ 0 }, std::plus<>{}, pool) == 999 * 1'000 / 2);
+		}
+	}
+
+	SECTION("any range")
+	{
+		std::vector<int> vec = { 1, 2, 3, 4, 5, 6 };
+		REQUIRE(Query{ vec }.filter([](int x) { return x % 2 == 0; }).map([](int x) { return x * x; }).reduce(0, std::plus<>{}) == 56);
+	}
+}
+
+TEST_CASE("ThreadPool")
+{
+	ThreadPool pool{ 4 };
+	REQUIRE(pool.size() == 4);
+
+	SECTION("submit returns a future")
+	{
+		auto answer = pool.submit([] { return 42; });
+		auto error = pool.submit([]() -> int { throw std::runtime_error("error"); });
+
+		REQUIRE(answer.get() == 42);
+		REQUIRE_THROWS_AS(error.get(), std::runtime_error);
+	}
+
+	SECTION("task waiting for a nested task does not deadlock")
+	{
+		ThreadPool single{ 1 }; // future.get() alone would block the only worker
+
+		auto outer = single.submit([&single] {
+			auto inner = single.submit([] { return 41; });
+			single.wait(inner);
+			return inner.get() + 1;
+		});
+
+		REQUIRE(outer.get() == 42);
+	}
+
+	SECTION("parallel_for visits every index once")
+	{
+		std::vector<std::atomic<int>> visits(100'000);
+		pool.parallel_for(0, visits.size(), [&visits](size_t i) { ++visits[i]; });
+
+		REQUIRE(std::all_of(visits.begin(), visits.end(), [](const auto& v) { return v == 1; }));
+	}
+
+	SECTION("nested parallel_for does not deadlock")
+	{
+		std::atomic<size_t> total{ 0 };
+		pool.parallel_for(0, 16, [&](size_t) {
+			pool.parallel_for(0, 1'000, [&total](size_t) { ++total; }, 10);
+		}, 1);
+
+		REQUIRE(total == 16'000);
+	}
+
+	SECTION("first exception is rethrown")
+	{
+		REQUIRE_THROWS_AS(pool.parallel_for(0, 1'000, [](size_t i) { if (i == 500) throw std::out_of_range("500"); }), std::out_of_range);
+	}
+}
+
+TEST_CASE("ThreadPool - scalability", "[.benchmark]")
+{
+	std::vector<double> data(20'000'000);
+	std::iota(data.begin(), data.end(), 0.0);
+
+	auto kernel = [&data](size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i)
+			data[i] = std::sqrt(data[i] * 1.5 + 1.0);
+	};
+
+	std::vector<size_t> thread_counts{ 1 };
+	for (size_t threads = 2; threads <= std::thread::hardware_concurrency(); threads *= 2)
+		thread_counts.push_back(threads);
+
+	for (size_t threads : thread_counts)
+	{
+		ThreadPool pool{ threads };
+
+		BENCHMARK("parallel_for - " + std::to_string(threads) + " threads")
+		{
+			pool.parallel_for_chunks(0, data.size(), kernel);
+			return data[0];
+		};
+	}
+}
+
+TEST_CASE("ConcurrentDataSet - many producers")
+{
+	ArrayTracing::Disable no_tracing;
+
+	const int no_of_threads = 8;
+	const int rows_per_thread = 10'000;
+
+	ConcurrentDataSet cds;
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < no_of_threads; ++t)
+	{
+		threads.emplace_back([&cds, t] {
+			auto producer = cds.producer();
+			for (int i = 0; i < rows_per_thread; ++i)
+				producer.add(Array{ t, i });
+		});
+	}
+
+	for (auto& thd : threads)
+		thd.join();
+
+	REQUIRE(cds.size() == no_of_threads * rows_per_thread);
+
+	DataSet ds = cds.collect();
+	REQUIRE(ds.rows.size() == no_of_threads * rows_per_thread);
+	REQUIRE(cds.size() == 0);
+
+	// every (thread, index) pair exactly once
+	std::vector<int> seen(no_of_threads * rows_per_thread);
+	for (const auto& row : ds.rows)
+		++seen[row[0] * rows_per_thread + row[1]];
+
+	REQUIRE(std::all_of(seen.begin(), seen.end(), [](int count) { return count == 1; }));
+}
+
+TEST_CASE("ConcurrentDataSet - scalability", "[.benchmark]")
+{
+	ArrayTracing::Disable no_tracing;
+
+	const int total_rows = 320'000;
+
+	for (int no_of_threads : { 1, 2, 4, 8, 16, 32 })
+	{
+		const int rows_per_thread = total_rows / no_of_threads;
+
+		BENCHMARK("DataSet + mutex - " + std::to_string(no_of_threads) + " threads")
+		{
+			DataSet ds;
+			std::mutex mtx;
+
+			std::vector<std::thread> threads;
+			for (int t = 0; t < no_of_threads; ++t)
+				threads.emplace_back([&, t] {
+					for (int i = 0; i < rows_per_thread; ++i)
+					{
+						std::lock_guard lk{ mtx };
+						ds.add(Array{ t, i });
+					}
+				});
+
+			for (auto& thd : threads)
+				thd.join();
+
+			return ds.rows.size();
+		};
+
+		BENCHMARK("ConcurrentDataSet - " + std::to_string(no_of_threads) + " threads")
+		{
+			ConcurrentDataSet cds;
+
+			std::vector<std::thread> threads;
+			for (int t = 0; t < no_of_threads; ++t)
+				threads.emplace_back([&, t] {
+					auto producer = cds.producer();
+					producer.reserve(rows_per_thread);
+					for (int i = 0; i < rows_per_thread; ++i)
+						producer.add(Array{ t, i });
+				});
+
+			for (auto& thd : threads)
+				thd.join();
+
+			return cds.size();
+		};
+	}
+}
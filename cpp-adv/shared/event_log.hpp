@@ -0,0 +1,321 @@
+#ifndef EVENT_LOG_HPP_
+#define EVENT_LOG_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "fast_output.hpp"
+
+// Low-overhead recorder of lifetime & call events
+// - every thread writes compact binary events to its own lock-free SPSC ring buffer - no lock, no I/O,
+//   no allocation on the hot path (only the first event of a thread registers its ring under a mutex)
+// - a background thread drains all rings & hands events to the sink given to start()
+// - when a ring is full the event is dropped & counted (a producer never waits for the drainer)
+// - the sink runs without the lock of the ring registry, so it may create traced objects (their events are
+//   drained in the next pass) & call flush() (which returns at once); it must not call start() or stop()
+// While nothing is recording, record() returns false & tracing points fall back to their text output.
+namespace EventLog
+{
+	enum class EventType : uint8_t
+	{
+		Construct,
+		CopyConstruct,
+		MoveConstruct,
+		CopyAssign,
+		MoveAssign,
+		Assign,
+		Destroy,
+		Call
+	};
+
+	inline const char* event_name(EventType type)
+	{
+		static constexpr const char* names[] = { "construct", "copy", "move", "copy assign", "move assign", "assign", "destroy", "call" };
+		return names[static_cast<size_t>(type)];
+	}
+
+	struct Event
+	{
+		uint64_t timestamp;   // ns since start()
+		const void* address;  // object the event is about
+		const char* label;    // static string (e.g. __FUNCSIG__) or nullptr
+		EventType type;
+	};
+
+	using Sink = std::function<void(uint32_t thread_id, const Event& event)>;
+
+	// single producer (owner thread), single consumer (drainer)
+	class Ring
+	{
+		static constexpr size_t capacity = 4096; // power of 2
+
+		alignas(64) std::atomic<size_t> head_{ 0 }; // next slot to write - written only by the producer
+		alignas(64) std::atomic<size_t> tail_{ 0 }; // next slot to read - written only by the consumer
+		alignas(64) std::array<Event, capacity> events_;
+
+	public:
+		const uint32_t thread_id;
+		std::atomic<bool> closed{ false }; // owner thread has exited
+
+		explicit Ring(uint32_t id) : thread_id{ id }
+		{
+		}
+
+		bool try_push(const Event& event) noexcept
+		{
+			const size_t head = head_.load(std::memory_order_relaxed);
+			if (head - tail_.load(std::memory_order_acquire) == capacity)
+				return false;
+
+			events_[head % capacity] = event;
+			head_.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		template <typename TFunction>
+		void drain(TFunction f)
+		{
+			const size_t tail = tail_.load(std::memory_order_relaxed);
+			const size_t head = head_.load(std::memory_order_acquire);
+
+			for (size_t i = tail; i != head; ++i)
+				f(events_[i % capacity]);
+
+			tail_.store(head, std::memory_order_release);
+		}
+
+		// called by the consumer
+		bool empty() const
+		{
+			return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+		}
+	};
+
+	class Logger
+	{
+		std::atomic<bool> recording_{ false };
+		std::atomic<uint64_t> dropped_{ 0 };
+		uint64_t epoch_ = 0; // steady clock ns at start() - read by the drainer only
+
+		std::mutex rings_mtx_; // rings_ & next_thread_id_ - never held while the sink runs
+		std::vector<std::shared_ptr<Ring>> rings_;
+		uint32_t next_thread_id_ = 0;
+
+		std::mutex drain_mtx_; // one drainer at a time; sink_, epoch_ & draining_, start & stop
+		std::vector<std::shared_ptr<Ring>> draining_; // copy of rings_ for one pass (capacity is reused)
+		Sink sink_;
+
+		std::thread drainer_;
+		std::atomic<bool> stop_requested_{ false };
+
+		// owner's handle - marks the ring closed when the thread exits
+		struct RingHandle
+		{
+			std::shared_ptr<Ring> ring;
+
+			~RingHandle()
+			{
+				if (ring)
+					ring->closed = true;
+			}
+		};
+
+		Ring& this_thread_ring()
+		{
+			static thread_local RingHandle handle;
+
+			if (!handle.ring)
+			{
+				std::lock_guard lk{ rings_mtx_ };
+				handle.ring = std::make_shared<Ring>(next_thread_id_++);
+				rings_.push_back(handle.ring);
+			}
+
+			return *handle.ring;
+		}
+
+		// true while this thread runs the sink
+		static bool& in_sink()
+		{
+			static thread_local bool flag = false;
+			return flag;
+		}
+
+		struct InSinkScope
+		{
+			InSinkScope()
+			{
+				in_sink() = true;
+			}
+
+			~InSinkScope()
+			{
+				in_sink() = false;
+			}
+		};
+
+		// must be called with drain_mtx_ locked
+		void drain_locked()
+		{
+			{
+				std::lock_guard lk{ rings_mtx_ };
+				draining_.assign(rings_.begin(), rings_.end());
+			}
+
+			InSinkScope scope;
+
+			for (auto& ring : draining_)
+			{
+				ring->drain([this, &ring](Event event) {
+					// late event of a previous recording (its producer passed is_recording() before stop())
+					if (event.timestamp < epoch_)
+						return;
+
+					event.timestamp -= epoch_;
+					if (sink_)
+						sink_(ring->thread_id, event);
+				});
+			}
+
+			draining_.clear();
+
+			// rings of exited threads are dropped once they are empty - closed is checked first,
+			// so no event can be pushed after the emptiness check
+			std::lock_guard lk{ rings_mtx_ };
+			rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+				return ring->closed && ring->empty();
+			}), rings_.end());
+		}
+
+	public:
+		~Logger()
+		{
+			stop();
+		}
+
+		bool is_recording() const
+		{
+			return recording_.load(std::memory_order_relaxed);
+		}
+
+		// false if nothing records events - the caller may fall back to text output
+		bool record(EventType type, const void* address, const char* label = nullptr) noexcept
+		{
+			if (!is_recording())
+				return false;
+
+			// absolute time - made relative to start() by the drainer
+			const auto timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+
+			try
+			{
+				if (!this_thread_ring().try_push(Event{ timestamp, address, label, type }))
+					dropped_.fetch_add(1, std::memory_order_relaxed);
+			}
+			catch (...) // registration of a new thread failed (bad_alloc)
+			{
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			return true;
+		}
+
+		void start(Sink sink, std::chrono::microseconds drain_interval = std::chrono::milliseconds(1))
+		{
+			stop();
+
+			std::lock_guard lk{ drain_mtx_ };
+
+			// leftovers of the previous recording are discarded
+			{
+				std::lock_guard rings_lk{ rings_mtx_ };
+				for (auto& ring : rings_)
+					ring->drain([](const Event&) {});
+			}
+
+			sink_ = std::move(sink);
+			epoch_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+			dropped_ = 0;
+			stop_requested_ = false;
+
+			drainer_ = std::thread([this, drain_interval] {
+				while (!stop_requested_)
+				{
+					std::this_thread::sleep_for(drain_interval);
+					std::lock_guard lk{ drain_mtx_ };
+					drain_locked();
+				}
+			});
+
+			recording_ = true;
+		}
+
+		// stops recording; events recorded so far are passed to the sink before stop() returns
+		// (an event recorded concurrently with stop() may be lost - it is discarded by the next start())
+		void stop()
+		{
+			recording_ = false;
+
+			if (drainer_.joinable())
+			{
+				stop_requested_ = true;
+				drainer_.join();
+			}
+
+			std::lock_guard lk{ drain_mtx_ };
+			drain_locked();
+			sink_ = nullptr;
+		}
+
+		// passes all events recorded so far to the sink - called from the sink it does nothing
+		// (the events are being drained already)
+		void flush()
+		{
+			if (in_sink())
+				return;
+
+			std::lock_guard lk{ drain_mtx_ };
+			drain_locked();
+		}
+
+		uint64_t dropped() const
+		{
+			return dropped_.load(std::memory_order_relaxed);
+		}
+	};
+
+	inline Logger& logger()
+	{
+		static Logger instance;
+		return instance;
+	}
+
+	inline bool is_recording()
+	{
+		return logger().is_recording();
+	}
+
+	inline bool record(EventType type, const void* address, const char* label = nullptr) noexcept
+	{
+		return logger().record(type, address, label);
+	}
+
+	// trace point for function signatures: trace_call(__FUNCSIG__) - printed when nothing records
+	inline void trace_call(const char* signature)
+	{
+		if (!record(EventType::Call, nullptr, signature))
+			FastOutput::Writer{} << signature << '\n';
+	}
+}
+
+#endif /*EVENT_LOG_HPP_*/
@@ -0,0 +1,214 @@
+#ifndef FAST_OUTPUT_HPP_
+#define FAST_OUTPUT_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Formatted output without iostream formatting
+// - numbers are formatted with std::to_chars (no locale, no sentry per value) into a thread-local buffer
+// - the buffer goes to std::cout in one write: when a Writer is destroyed (one write per message),
+//   or - inside a Batch - when the buffer is full or the outermost Batch ends (one write per 64 KiB)
+// - output stays in order with other std::cout output as long as it is not interleaved inside a Batch
+// Types without a to_chars/string_view conversion are streamed with operator<< (buffer is flushed first).
+namespace FastOutput
+{
+	class Buffer
+	{
+		static constexpr size_t capacity = 64 * 1024;
+
+		char data_[capacity];
+		size_t size_ = 0;
+		int batch_depth_ = 0;
+
+		friend class Batch;
+		friend class Writer;
+
+	public:
+		Buffer() = default;
+		Buffer(const Buffer&) = delete;
+		Buffer& operator=(const Buffer&) = delete;
+
+		~Buffer()
+		{
+			flush();
+		}
+
+		void flush()
+		{
+			if (size_ != 0)
+			{
+				std::cout.write(data_, static_cast<std::streamsize>(size_));
+				size_ = 0;
+			}
+		}
+
+		void append(std::string_view text)
+		{
+			while (!text.empty())
+			{
+				if (size_ == capacity)
+					flush();
+
+				const size_t count = std::min(capacity - size_, text.size());
+				text.copy(data_ + size_, count);
+				size_ += count;
+				text.remove_prefix(count);
+			}
+		}
+
+		// formats a value straight into the buffer - MaxSize must cover the longest result
+		template <size_t MaxSize, typename TFormat>
+		void append_formatted(TFormat format)
+		{
+			if (capacity - size_ < MaxSize)
+				flush();
+
+			size_ = static_cast<size_t>(format(data_ + size_, data_ + capacity) - data_);
+		}
+	};
+
+	inline Buffer& thread_buffer()
+	{
+		static thread_local Buffer buffer;
+		return buffer;
+	}
+
+	inline void flush()
+	{
+		thread_buffer().flush();
+	}
+
+	// output of all Writers in the scope (on this thread) is written in large blocks
+	class Batch
+	{
+	public:
+		Batch()
+		{
+			++thread_buffer().batch_depth_;
+		}
+
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+
+		~Batch()
+		{
+			Buffer& buffer = thread_buffer();
+			if (--buffer.batch_depth_ == 0)
+				buffer.flush();
+		}
+	};
+
+	// char, signed char & unsigned char (also int8_t & uint8_t) - written as characters, like std::cout does
+	template <typename T>
+	inline constexpr bool IsCharacter_v = std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+	struct EndLine
+	{
+	};
+
+	inline constexpr EndLine endl{};
+
+	// FastOutput::Writer{} << "x = " << x << '\n';
+	class Writer
+	{
+		Buffer& buffer_ = thread_buffer();
+
+	public:
+		Writer() = default;
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+
+		~Writer()
+		{
+			if (buffer_.batch_depth_ == 0)
+				buffer_.flush();
+		}
+
+		Writer& operator<<(std::string_view text)
+		{
+			buffer_.append(text);
+			return *this;
+		}
+
+		Writer& operator<<(const char* text)
+		{
+			buffer_.append(text != nullptr ? std::string_view(text) : std::string_view("(null)"));
+			return *this;
+		}
+
+		Writer& operator<<(const std::string& text)
+		{
+			buffer_.append(text);
+			return *this;
+		}
+
+		template <typename T, std::enable_if_t<IsCharacter_v<T>, int> = 0>
+		Writer& operator<<(T c)
+		{
+			const char text = static_cast<char>(c);
+			buffer_.append(std::string_view(&text, 1));
+			return *this;
+		}
+
+		Writer& operator<<(bool value)
+		{
+			buffer_.append(value ? "1" : "0"); // as std::cout without std::boolalpha
+			return *this;
+		}
+
+		template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !IsCharacter_v<T> && !std::is_same_v<T, bool>>>
+		Writer& operator<<(T value)
+		{
+			buffer_.append_formatted<24>([value](char* first, char* last) { return std::to_chars(first, last, value).ptr; });
+			return *this;
+		}
+
+		// 6 significant digits in the shorter of fixed & scientific notation - as std::cout's default
+		Writer& operator<<(double value)
+		{
+			buffer_.append_formatted<32>([value](char* first, char* last) { return std::to_chars(first, last, value, std::chars_format::general, 6).ptr; });
+			return *this;
+		}
+
+		// to_chars of long double is missing in some standard libraries - through std::cout
+		Writer& operator<<(long double value)
+		{
+			buffer_.flush();
+			std::cout << value;
+			return *this;
+		}
+
+		// format of pointers depends on the standard library - through std::cout
+		Writer& operator<<(const void* ptr)
+		{
+			buffer_.flush();
+			std::cout << ptr;
+			return *this;
+		}
+
+		// '\n' & flush of std::cout - as std::endl (also inside a Batch)
+		Writer& operator<<(EndLine)
+		{
+			buffer_.append("\n");
+			buffer_.flush();
+			std::cout.flush();
+			return *this;
+		}
+
+		// anything else - through std::cout
+		template <typename T, typename = std::enable_if_t<!std::is_arithmetic_v<T> && !std::is_pointer_v<T> && !std::is_convertible_v<const T&, std::string_view>>, typename = void>
+		Writer& operator<<(const T& value)
+		{
+			buffer_.flush();
+			std::cout << value;
+			return *this;
+		}
+	};
+}
+
+#endif /*FAST_OUTPUT_HPP_*/
@@ -0,0 +1,325 @@
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Work-stealing thread pool
+// - every worker has its own deque: the owner pushes & pops at the back (LIFO - hot in cache),
+//   idle workers steal from the front of other deques (FIFO - the oldest, usually the largest, work)
+// - tasks submitted from outside the pool are spread round-robin over the deques
+// - parallel_for splits its range recursively; a stolen half is split again by the thief,
+//   so chunk sizes adapt to the load without tuning (grain is only the lower bound)
+// - waiting inside the pool (parallel_for, wait(future)) runs pending tasks instead of blocking a worker;
+//   a thread outside the pool blocks until its parallel_for is done
+// - a task must not call get() on a future of submit() before wait(future) - get() blocks the worker,
+//   and once every worker waits like that, the tasks queued behind them never run
+class ThreadPool
+{
+	using Task = std::function<void()>;
+
+	struct alignas(64) Queue
+	{
+		std::mutex mtx;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::vector<std::thread> threads_;
+	std::atomic<size_t> pending_{ 0 };
+	std::atomic<size_t> next_queue_{ 0 };
+	bool done_ = false;
+	std::mutex sleep_mtx_;
+	std::condition_variable sleep_cv_;
+
+	struct WorkerContext
+	{
+		const ThreadPool* pool = nullptr;
+		size_t index = 0;
+	};
+
+	static WorkerContext& this_worker()
+	{
+		static thread_local WorkerContext context;
+		return context;
+	}
+
+	void push(Task task)
+	{
+		const WorkerContext& worker = this_worker();
+		const size_t index = worker.pool == this ? worker.index : next_queue_++ % queues_.size();
+
+		{
+			std::lock_guard lk{ sleep_mtx_ }; // no lost wake-up between a worker's check & wait
+			++pending_; // counted before it is visible, so pop() never takes pending_ below 0
+		}
+
+		try
+		{
+			std::lock_guard lk{ queues_[index]->mtx };
+			queues_[index]->tasks.push_back(std::move(task));
+		}
+		catch (...)
+		{
+			--pending_;
+			throw;
+		}
+
+		sleep_cv_.notify_one();
+	}
+
+	bool pop(size_t index, Task& task)
+	{
+		// own deque - newest task
+		{
+			Queue& queue = *queues_[index];
+			std::lock_guard lk{ queue.mtx };
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+				--pending_;
+				return true;
+			}
+		}
+
+		// steal - oldest task of another deque
+		for (size_t i = 1; i < queues_.size(); ++i)
+		{
+			Queue& victim = *queues_[(index + i) % queues_.size()];
+			std::lock_guard lk{ victim.mtx };
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				--pending_;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void run_worker(size_t index)
+	{
+		this_worker() = WorkerContext{ this, index };
+
+		Task task;
+		while (true)
+		{
+			if (pop(index, task))
+			{
+				task();
+				task = nullptr;
+				continue;
+			}
+
+			std::unique_lock lk{ sleep_mtx_ };
+			sleep_cv_.wait(lk, [this] { return pending_ != 0 || done_; });
+			if (done_ && pending_ == 0)
+				return;
+		}
+	}
+
+	template <typename TFunction>
+	struct ForState
+	{
+		TFunction f;
+		size_t grain;
+		std::atomic<size_t> remaining;
+		std::mutex mtx; // error & done_cv
+		std::condition_variable done_cv;
+		std::exception_ptr error;
+
+		ForState(TFunction f, size_t grain, size_t size) : f{ std::move(f) }, grain{ grain }, remaining{ size }
+		{
+		}
+
+		// count elements are finished (processed or failed) - wakes the waiting thread after the last one
+		void finish(size_t count)
+		{
+			if (remaining.fetch_sub(count) == count)
+			{
+				std::lock_guard lk{ mtx };
+				done_cv.notify_all();
+			}
+		}
+
+		// must be called in a catch block
+		void fail(size_t count)
+		{
+			{
+				std::lock_guard lk{ mtx };
+				if (!error)
+					error = std::current_exception();
+			}
+			finish(count);
+		}
+	};
+
+	template <typename TFunction>
+	void split(std::shared_ptr<ForState<TFunction>> state, size_t first, size_t last)
+	{
+		while (last - first > state->grain)
+		{
+			const size_t middle = first + (last - first) / 2;
+			try
+			{
+				push([this, state, middle, last] { split(state, middle, last); });
+			}
+			catch (...) // not scheduled (bad_alloc) - the second half is failed, the first one still runs here
+			{
+				state->fail(last - middle);
+			}
+			last = middle;
+		}
+
+		try
+		{
+			state->f(first, last);
+		}
+		catch (...)
+		{
+			state->fail(last - first);
+			return;
+		}
+
+		state->finish(last - first);
+	}
+
+public:
+	explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+	{
+		threads = std::max<size_t>(threads, 1);
+
+		for (size_t i = 0; i < threads; ++i)
+			queues_.push_back(std::make_unique<Queue>());
+
+		threads_.reserve(threads);
+		for (size_t i = 0; i < threads; ++i)
+			threads_.emplace_back([this, i] { run_worker(i); });
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// runs all submitted tasks before joining the workers
+	~ThreadPool()
+	{
+		{
+			std::lock_guard lk{ sleep_mtx_ };
+			done_ = true;
+		}
+		sleep_cv_.notify_all();
+
+		for (auto& thread : threads_)
+			thread.join();
+	}
+
+	size_t size() const
+	{
+		return threads_.size();
+	}
+
+	// inside a task wait for the result with wait(future) before future.get()
+	template <typename TFunction>
+	auto submit(TFunction&& f) -> std::future<std::invoke_result_t<std::decay_t<TFunction>>>
+	{
+		using Result = std::invoke_result_t<std::decay_t<TFunction>>;
+
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<TFunction>(f));
+		std::future<Result> result = task->get_future();
+		push([task] { (*task)(); });
+
+		return result;
+	}
+
+	// runs one pending task on the calling thread; false if there was none
+	bool run_pending_task()
+	{
+		const WorkerContext& worker = this_worker();
+
+		Task task;
+		if (!pop(worker.pool == this ? worker.index : 0, task))
+			return false;
+
+		task();
+		return true;
+	}
+
+	// blocks until future is ready - on a worker of this pool pending tasks are run meanwhile
+	template <typename T>
+	void wait(const std::future<T>& future)
+	{
+		if (this_worker().pool != this)
+		{
+			future.wait();
+			return;
+		}
+
+		while (future.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+		{
+			if (!run_pending_task())
+				std::this_thread::yield();
+		}
+	}
+
+	// f(chunk_first, chunk_last) for disjoint chunks covering [first, last) - returns when all chunks are done
+	// default grain gives about 8 chunks per thread; the first exception thrown by f is rethrown
+	template <typename TFunction>
+	void parallel_for_chunks(size_t first, size_t last, TFunction f, size_t grain = 0)
+	{
+		if (first >= last)
+			return;
+
+		if (grain == 0)
+			grain = std::max<size_t>(1, (last - first) / (8 * size()));
+
+		auto state = std::make_shared<ForState<TFunction>>(std::move(f), grain, last - first);
+
+		split(state, first, last);
+
+		if (this_worker().pool == this)
+		{
+			// a worker must not block - it could wait for tasks queued behind it
+			while (state->remaining != 0)
+			{
+				if (!run_pending_task())
+					std::this_thread::yield();
+			}
+		}
+		else
+		{
+			std::unique_lock lk{ state->mtx };
+			state->done_cv.wait(lk, [&state] { return state->remaining == 0; });
+		}
+
+		if (state->error)
+			std::rethrow_exception(state->error);
+	}
+
+	// f(i) for every i in [first, last)
+	template <typename TFunction>
+	void parallel_for(size_t first, size_t last, TFunction f, size_t grain = 0)
+	{
+		parallel_for_chunks(first, last, [f = std::move(f)](size_t chunk_first, size_t chunk_last) {
+			for (size_t i = chunk_first; i < chunk_last; ++i)
+				f(i);
+		}, grain);
+	}
+};
+
+#endif /*THREAD_POOL_HPP_*/
@@ -0,0 +1,115 @@
+#ifndef OBJECT_POOL_HPP_
+#define OBJECT_POOL_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Fixed-size object pool - slots are carved from chunks and recycled through an intrusive free list,
+// so create()/destroy() never touch the global allocator once the pool is warmed up.
+// Not thread-safe: one pool per thread (or external synchronization).
+template <typename T>
+class ObjectPool
+{
+    union Slot
+    {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    size_t chunk_size_;
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    Slot* free_list_ = nullptr;
+    size_t in_use_ = 0;
+
+    void grow()
+    {
+        std::unique_ptr<Slot[]> chunk{ new Slot[chunk_size_] };
+
+        for (size_t i = 0; i < chunk_size_; ++i)
+            chunk[i].next = (i + 1 < chunk_size_) ? &chunk[i + 1] : free_list_;
+
+        free_list_ = &chunk[0];
+        chunks_.push_back(std::move(chunk));
+    }
+
+public:
+    explicit ObjectPool(size_t chunk_size = 256) : chunk_size_{ chunk_size }
+    {
+        assert(chunk_size_ > 0);
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ~ObjectPool()
+    {
+        assert(in_use_ == 0); // all objects must be returned before the pool dies
+    }
+
+    template <typename... TArgs>
+    T* create(TArgs&&... args)
+    {
+        if (free_list_ == nullptr)
+            grow();
+
+        Slot* slot = free_list_;
+        free_list_ = slot->next;
+
+        try
+        {
+            T* obj = ::new (static_cast<void*>(slot->storage)) T(std::forward<TArgs>(args)...);
+            ++in_use_;
+            return obj;
+        }
+        catch (...)
+        {
+            slot->next = free_list_;
+            free_list_ = slot;
+            throw;
+        }
+    }
+
+    void destroy(T* obj) noexcept
+    {
+        assert(obj != nullptr);
+
+        obj->~T();
+
+        Slot* slot = reinterpret_cast<Slot*>(obj);
+        slot->next = free_list_;
+        free_list_ = slot;
+        --in_use_;
+    }
+
+    size_t size() const
+    {
+        return in_use_;
+    }
+
+    size_t capacity() const
+    {
+        return chunks_.size() * chunk_size_;
+    }
+};
+
+// Deleter returning objects to the pool they came from
+template <typename T>
+class PoolDeleter
+{
+    ObjectPool<T>* pool_;
+
+public:
+    explicit PoolDeleter(ObjectPool<T>& pool) : pool_{ &pool }
+    {}
+
+    void operator()(T* ptr) const noexcept
+    {
+        pool_->destroy(ptr);
+    }
+};
+
+#endif /*OBJECT_POOL_HPP_*/
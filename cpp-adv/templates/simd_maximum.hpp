@@ -0,0 +1,287 @@
+#ifndef SIMD_MAXIMUM_HPP_
+#define SIMD_MAXIMUM_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_MAXIMUM_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace Simd
+{
+    namespace Detail
+    {
+        // generic path - select instead of branch, compilers emit cmov/maxps for it
+        template <typename T>
+        std::pair<T, T> reduce_minmax(const T* data, size_t size)
+        {
+            T min = data[0];
+            T max = data[0];
+
+            for (size_t i = 1; i < size; ++i)
+            {
+                min = data[i] < min ? data[i] : min;
+                max = max < data[i] ? data[i] : max;
+            }
+
+            return { min, max };
+        }
+
+        template <typename T>
+        T reduce_max(const T* data, size_t size)
+        {
+            T max = data[0];
+
+            for (size_t i = 1; i < size; ++i)
+                max = max < data[i] ? data[i] : max;
+
+            return max;
+        }
+
+#ifdef SIMD_MAXIMUM_SSE2
+        // SSE2 has no _mm_max_epi32/_mm_min_epi32 - blend with compare mask
+        inline __m128i max_epi32(__m128i a, __m128i b)
+        {
+            __m128i mask = _mm_cmpgt_epi32(a, b);
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        inline __m128i min_epi32(__m128i a, __m128i b)
+        {
+            __m128i mask = _mm_cmpgt_epi32(a, b);
+            return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+        }
+
+        struct Int32Ops
+        {
+            using value_type = int32_t;
+            using vector_type = __m128i;
+            static constexpr size_t width = 4;
+
+            static __m128i load(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            static void store(int32_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+            static __m128i max(__m128i a, __m128i b) { return max_epi32(a, b); }
+            static __m128i min(__m128i a, __m128i b) { return min_epi32(a, b); }
+        };
+
+        struct FloatOps
+        {
+            using value_type = float;
+            using vector_type = __m128;
+            static constexpr size_t width = 4;
+
+            static __m128 load(const float* p) { return _mm_loadu_ps(p); }
+            static void store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+            static __m128 max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+            static __m128 min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+        };
+
+        struct DoubleOps
+        {
+            using value_type = double;
+            using vector_type = __m128d;
+            static constexpr size_t width = 2;
+
+            static __m128d load(const double* p) { return _mm_loadu_pd(p); }
+            static void store(double* p, __m128d v) { _mm_storeu_pd(p, v); }
+            static __m128d max(__m128d a, __m128d b) { return _mm_max_pd(a, b); }
+            static __m128d min(__m128d a, __m128d b) { return _mm_min_pd(a, b); }
+        };
+
+        template <typename T>
+        struct SimdOps
+        {
+            using type = void;
+        };
+
+        template <>
+        struct SimdOps<int32_t>
+        {
+            using type = Int32Ops;
+        };
+
+        template <>
+        struct SimdOps<float>
+        {
+            using type = FloatOps;
+        };
+
+        template <>
+        struct SimdOps<double>
+        {
+            using type = DoubleOps;
+        };
+
+        // two independent accumulators hide the latency of max/min instructions
+        template <typename Ops>
+        typename Ops::value_type simd_reduce_max(const typename Ops::value_type* data, size_t size)
+        {
+            using T = typename Ops::value_type;
+            constexpr size_t step = 2 * Ops::width;
+
+            if (size < step)
+                return reduce_max(data, size);
+
+            auto acc1 = Ops::load(data);
+            auto acc2 = Ops::load(data + Ops::width);
+
+            size_t i = step;
+            for (; i + step <= size; i += step)
+            {
+                acc1 = Ops::max(acc1, Ops::load(data + i));
+                acc2 = Ops::max(acc2, Ops::load(data + i + Ops::width));
+            }
+
+            T lanes[Ops::width];
+            Ops::store(lanes, Ops::max(acc1, acc2));
+
+            T max = reduce_max(lanes, Ops::width);
+            for (; i < size; ++i)
+                max = max < data[i] ? data[i] : max;
+
+            return max;
+        }
+
+        template <typename Ops>
+        std::pair<typename Ops::value_type, typename Ops::value_type> simd_reduce_minmax(const typename Ops::value_type* data, size_t size)
+        {
+            using T = typename Ops::value_type;
+
+            if (size < Ops::width)
+                return reduce_minmax(data, size);
+
+            auto min_acc = Ops::load(data);
+            auto max_acc = min_acc;
+
+            size_t i = Ops::width;
+            for (; i + Ops::width <= size; i += Ops::width)
+            {
+                auto v = Ops::load(data + i);
+                min_acc = Ops::min(min_acc, v);
+                max_acc = Ops::max(max_acc, v);
+            }
+
+            T min_lanes[Ops::width];
+            T max_lanes[Ops::width];
+            Ops::store(min_lanes, min_acc);
+            Ops::store(max_lanes, max_acc);
+
+            T min = reduce_minmax(min_lanes, Ops::width).first;
+            T max = reduce_max(max_lanes, Ops::width);
+            for (; i < size; ++i)
+            {
+                min = data[i] < min ? data[i] : min;
+                max = max < data[i] ? data[i] : max;
+            }
+
+            return { min, max };
+        }
+
+        inline unsigned count_trailing_zeros(unsigned mask)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+#endif
+
+        template <typename T>
+        T dispatch_max(const T* data, size_t size)
+        {
+#ifdef SIMD_MAXIMUM_SSE2
+            if constexpr (!std::is_void_v<typename SimdOps<T>::type>)
+                return simd_reduce_max<typename SimdOps<T>::type>(data, size);
+            else
+#endif
+                return reduce_max(data, size);
+        }
+
+        template <typename T>
+        std::pair<T, T> dispatch_minmax(const T* data, size_t size)
+        {
+#ifdef SIMD_MAXIMUM_SSE2
+            if constexpr (!std::is_void_v<typename SimdOps<T>::type>)
+                return simd_reduce_minmax<typename SimdOps<T>::type>(data, size);
+            else
+#endif
+                return reduce_minmax(data, size);
+        }
+
+        template <typename TRange>
+        using RangeValue_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<const TRange&>()))>>;
+    }
+
+    // maximum of a non-empty contiguous range of arithmetic values
+    // int32_t, float & double use SSE2 when available; result for ranges with NaN is unspecified
+    template <typename TRange>
+    Detail::RangeValue_t<TRange> maximum(const TRange& range)
+    {
+        static_assert(std::is_arithmetic_v<Detail::RangeValue_t<TRange>>, "arithmetic values required");
+        assert(std::size(range) > 0);
+
+        return Detail::dispatch_max(std::data(range), std::size(range));
+    }
+
+    template <typename TRange>
+    std::pair<Detail::RangeValue_t<TRange>, Detail::RangeValue_t<TRange>> minmax(const TRange& range)
+    {
+        static_assert(std::is_arithmetic_v<Detail::RangeValue_t<TRange>>, "arithmetic values required");
+        assert(std::size(range) > 0);
+
+        return Detail::dispatch_minmax(std::data(range), std::size(range));
+    }
+
+    // lexicographical compare of bytes (as unsigned char) - 16 bytes per step, no strlen needed
+    inline int compare(std::string_view a, std::string_view b)
+    {
+        const size_t common = a.size() < b.size() ? a.size() : b.size();
+        size_t i = 0;
+
+#ifdef SIMD_MAXIMUM_SSE2
+        for (; i + 16 <= common; i += 16)
+        {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + i));
+
+            unsigned diff = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) ^ 0xFFFFu;
+            if (diff != 0)
+            {
+                size_t pos = i + Detail::count_trailing_zeros(diff);
+                return static_cast<unsigned char>(a[pos]) < static_cast<unsigned char>(b[pos]) ? -1 : 1;
+            }
+        }
+#endif
+
+        for (; i < common; ++i)
+        {
+            if (a[i] != b[i])
+                return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]) ? -1 : 1;
+        }
+
+        if (a.size() == b.size())
+            return 0;
+
+        return a.size() < b.size() ? -1 : 1;
+    }
+
+    inline std::string_view maximum(std::string_view a, std::string_view b)
+    {
+        return compare(a, b) < 0 ? b : a;
+    }
+}
+
+#endif /*SIMD_MAXIMUM_HPP_*/
@@ -4,6 +4,18 @@
 #include <vector>
 #include <list>
 #include <optional>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <variant>
+#include <atomic>
+#include <numeric>
+
+#include "object_pool.hpp"
+#include "simd_maximum.hpp"
+#include "fast_output.hpp"
+#include "thread_pool.hpp"
+#include "event_log.hpp"
 
 using namespace std;
 
@@ -40,6 +52,44 @@ TEST_CASE("Test")
     REQUIRE(maximum(ctxt1, ctxt2) == "def"s);
 }
 
+TEST_CASE("maximum - ranges")
+{
+    SECTION("int")
+    {
+        vector<int> scores(1003);
+        for (size_t i = 0; i < scores.size(); ++i)
+            scores[i] = static_cast<int>((i * 7919) % 1000) - 500;
+
+        REQUIRE(Simd::maximum(scores) == *max_element(scores.begin(), scores.end()));
+
+        scores.back() = 10'000; // tail element
+        scores[5] = -10'000;
+        REQUIRE(Simd::maximum(scores) == 10'000);
+        REQUIRE(Simd::minmax(scores) == pair{ -10'000, 10'000 });
+    }
+
+    SECTION("floating point")
+    {
+        vector<double> values = { 0.5, -1.5, 3.25, 2.0, 9.75, -7.0, 1.0 };
+        REQUIRE(Simd::maximum(values) == 9.75);
+
+        float fvalues[] = { 1.0f, 2.0f, -3.0f };
+        REQUIRE(Simd::minmax(fvalues) == pair{ -3.0f, 2.0f });
+    }
+
+    SECTION("strings")
+    {
+        std::string prefix(40, 'x');
+        std::string a = prefix + "abc";
+        std::string b = prefix + "abd";
+
+        REQUIRE(Simd::maximum(a, b) == b);
+        REQUIRE(Simd::maximum(prefix, a) == a);
+        REQUIRE(Simd::compare(a, a) == 0);
+        REQUIRE(Simd::compare("\xff", "a") > 0); // bytes compared as unsigned
+    }
+}
+
 template <typename TResult, typename T1, typename T2>
 TResult multiply1(T1 a, T2 b)
 {
@@ -84,9 +134,81 @@ decltype(auto) element_at(Container& container, size_t index)
 {
     auto it = begin(container);
 
-    advance(it, index);
+    using Category = typename iterator_traits<decltype(it)>::iterator_category;
+
+    if constexpr (is_base_of_v<random_access_iterator_tag, Category>)
+    {
+        return it[index]; // O(1)
+    }
+    else
+    {
+        advance(it, index); // O(n)
 
-    return *it; // *it -> int&
+        return *it; // *it -> int&
+    }
+}
+
+// indexed access to a list - remembers the last visited position,
+// so sequential or nearby accesses are O(1) amortized
+// insert/erase in the list invalidates the cursor - call reset()
+template <typename TList>
+class IndexedList
+{
+    using Iterator = decltype(std::begin(std::declval<TList&>()));
+
+    TList& list_;
+    Iterator cursor_;
+    size_t cursor_index_ = 0;
+
+public:
+    using value_type = typename TList::value_type;
+
+    explicit IndexedList(TList& list) : list_{list}, cursor_{list.begin()}
+    {}
+
+    size_t size() const
+    {
+        return list_.size();
+    }
+
+    void reset()
+    {
+        cursor_ = list_.begin();
+        cursor_index_ = 0;
+    }
+
+    decltype(auto) operator[](size_t index)
+    {
+        assert(index < list_.size());
+
+        if (cursor_ == list_.end())
+            reset();
+
+        // start from the closest known position: cursor, front or back
+        const size_t last_index = list_.size() - 1;
+        const size_t distance_from_cursor = index > cursor_index_ ? index - cursor_index_ : cursor_index_ - index;
+
+        if (index < distance_from_cursor && index <= last_index - index)
+        {
+            reset();
+        }
+        else if (last_index - index < distance_from_cursor)
+        {
+            cursor_ = std::prev(list_.end());
+            cursor_index_ = last_index;
+        }
+
+        std::advance(cursor_, static_cast<ptrdiff_t>(index) - static_cast<ptrdiff_t>(cursor_index_));
+        cursor_index_ = index;
+
+        return *cursor_;
+    }
+};
+
+template <typename TList>
+decltype(auto) element_at(IndexedList<TList>& container, size_t index)
+{
+    return container[index];
 }
 
 TEST_CASE("templates & return types")
@@ -104,6 +226,39 @@ TEST_CASE("templates & return types")
 
         REQUIRE(lst.front() == 42);
     }
+
+    SECTION("random access")
+    {
+        vector vec = { 1, 2, 3, 4 };
+        element_at(vec, 3) = 42;
+
+        REQUIRE(vec.back() == 42);
+    }
+
+    SECTION("indexed list")
+    {
+        list<int> lst;
+        for (int i = 0; i < 1000; ++i)
+            lst.push_back(i);
+
+        IndexedList indexed{ lst };
+
+        int sum = 0;
+        for (size_t i = 0; i < indexed.size(); ++i)
+            sum += element_at(indexed, i);
+        REQUIRE(sum == 999 * 1000 / 2);
+
+        for (size_t i = indexed.size(); i-- > 0; )
+            REQUIRE(indexed[i] == static_cast<int>(i));
+
+        element_at(indexed, 500) = -1;
+        REQUIRE(*next(lst.begin(), 500) == -1);
+
+        const list<int>& clst = lst;
+        IndexedList cindexed{ clst };
+        REQUIRE(cindexed[999] == 999);
+        REQUIRE(cindexed[1] == 1);
+    }
 }
 
 template <typename Iter, typename Predicate>
@@ -138,9 +293,51 @@ TEST_CASE("generic algorithm")
     REQUIRE(*pos == 42);
 }
 
-template <typename T>
+// the first match wins - chunks after a match already found are skipped
+template <typename Iter, typename Predicate>
+Iter parallel_find_if(ThreadPool& pool, Iter first, Iter last, Predicate predicate)
+{
+    static_assert(is_base_of_v<random_access_iterator_tag, typename iterator_traits<Iter>::iterator_category>);
+
+    const size_t size = static_cast<size_t>(last - first);
+    atomic<size_t> found{ size };
+
+    pool.parallel_for_chunks(0, size, [&](size_t chunk_first, size_t chunk_last) {
+        for (size_t i = chunk_first; i < chunk_last && i < found; ++i)
+        {
+            if (predicate(first[i]))
+            {
+                size_t current = found;
+                while (i < current && !found.compare_exchange_weak(current, i))
+                    ;
+                return;
+            }
+        }
+    });
+
+    return first + found;
+}
+
+TEST_CASE("generic algorithm - parallel")
+{
+    ThreadPool pool{ 4 };
+
+    vector<int32_t> vec(1'000'000, 1);
+    vec[700'000] = 42;
+    vec[900'000] = 66;
+
+    auto pos = parallel_find_if(pool, vec.begin(), vec.end(), is_even);
+    REQUIRE(pos - vec.begin() == 700'000);
+
+    pos = parallel_find_if(pool, vec.begin(), vec.end(), [](int x) { return x < 0; });
+    REQUIRE(pos == vec.end());
+}
+
+template <typename T, typename Deleter = std::default_delete<std::remove_pointer_t<T>>>
 class Holder
 {
+    static_assert(std::is_same_v<Deleter, std::default_delete<T>>, "Holder: Deleter is used only by Holder<T*>");
+
     T item_;
 public:
     using value_type = T;
@@ -155,7 +352,7 @@ public:
     template <typename... TValue>
     Holder(std::in_place_t, TValue&&... value) : item_(std::forward<TValue>(value)...)
     {
-        puts(__FUNCSIG__);
+        EventLog::trace_call(__FUNCSIG__);
     }
 
     Holder(const Holder&) = default;
@@ -172,37 +369,86 @@ public:
 
     void info() const
     {
-        std::cout << "Holder<T: " << typeid(T).name() << ">(" << item_ << ")\n";
+        FastOutput::Writer{} << "Holder<T: " << typeid(T).name() << ">(" << item_ << ")\n";
     }
 };
 
-template <typename T>
-class Holder<T*>
+// pointer + deleter; EBO only for empty, non-final deleter classes (function pointers & final classes are members),
+// so names of the deleter never leak into the owner's scope
+template <typename TPointer, typename TDeleter, bool = std::is_empty_v<TDeleter> && !std::is_final_v<TDeleter>>
+struct CompressedPointer : private TDeleter
+{
+    TPointer ptr;
+
+    CompressedPointer(TPointer ptr, TDeleter deleter) : TDeleter(std::move(deleter)), ptr{ptr}
+    {}
+
+    TDeleter& deleter() noexcept
+    {
+        return *this;
+    }
+
+    const TDeleter& deleter() const noexcept
+    {
+        return *this;
+    }
+};
+
+template <typename TPointer, typename TDeleter>
+struct CompressedPointer<TPointer, TDeleter, false>
 {
-    T* ptr_;
+    TPointer ptr;
+    TDeleter deleter_;
+
+    CompressedPointer(TPointer ptr, TDeleter deleter) : ptr{ptr}, deleter_(std::move(deleter))
+    {}
+
+    TDeleter& deleter() noexcept
+    {
+        return deleter_;
+    }
+
+    const TDeleter& deleter() const noexcept
+    {
+        return deleter_;
+    }
+};
+
+template <typename T, typename Deleter>
+class Holder<T*, Deleter>
+{
+    CompressedPointer<T*, Deleter> ptr_; // stateless deleter takes no space
+
+    void dispose() noexcept
+    {
+        if (ptr_.ptr != nullptr)
+            get_deleter()(ptr_.ptr);
+    }
+
 public:
     using value_type = T;
+    using deleter_type = Deleter;
 
-    Holder(T* ptr) : ptr_{ptr}
+    Holder(T* ptr, Deleter deleter = Deleter())
+        : ptr_{ptr, std::move(deleter)}
     {}
 
     Holder(const Holder&) = delete;
     Holder& operator=(const Holder&) = delete;
 
     Holder(Holder&& other) noexcept
-        : ptr_{ other.ptr_ }
+        : ptr_{std::exchange(other.ptr_.ptr, nullptr), std::move(other.get_deleter())}
     {
-        other.ptr_ = nullptr;
     }
 
     Holder& operator=(Holder&& other) noexcept
     {
         if (this != &other)
         {
-            this->~Holder();
+            dispose();
 
-            ptr_ = other.ptr_;
-            other.ptr_ = nullptr;
+            ptr_.ptr = std::exchange(other.ptr_.ptr, nullptr);
+            get_deleter() = std::move(other.get_deleter());
         }
 
         return *this;
@@ -210,31 +456,41 @@ public:
 
     ~Holder() noexcept
     {
-        delete ptr_;
+        dispose();
+    }
+
+    Deleter& get_deleter() noexcept
+    {
+        return ptr_.deleter();
+    }
+
+    const Deleter& get_deleter() const noexcept
+    {
+        return ptr_.deleter();
     }
 
     const T& value() const
     {
-        assert(ptr_ != nullptr);
-        return *ptr_;
+        assert(ptr_.ptr != nullptr);
+        return *ptr_.ptr;
     }
 
     T& value()
     {
-        assert(ptr_ != nullptr);
-        return *ptr_;
+        assert(ptr_.ptr != nullptr);
+        return *ptr_.ptr;
     }
 
     void info() const
     {
-        std::cout << "Holder<T*: " << typeid(T).name() << ">(" << *ptr_ << " - " << ptr_ << ")\n";
+        FastOutput::Writer{} << "Holder<T*: " << typeid(T).name() << ">(" << *ptr_.ptr << " - " << ptr_.ptr << ")\n";
     }
 };
 
 template <>
 class Holder<const char*>
 {
-    const char* text_;
+    string_view text_; // length computed once - value().size() is O(1)
 
 public:
     using value_type = const char*;
@@ -251,7 +507,74 @@ public:
 
     void info() const
     {
-        cout << "Holder<const char*>(" << text_ << ")" << endl;
+        FastOutput::Writer{} << "Holder<const char*>(" << text_ << ")\n";
+    }
+};
+
+// string literal - length known at compile time
+template <size_t N>
+class Holder<const char[N]>
+{
+    const char* text_;
+
+public:
+    using value_type = const char*;
+
+    static constexpr size_t length = N - 1;
+
+    constexpr Holder(const char (&text)[N])
+        : text_{ text }
+    {
+    }
+
+    constexpr string_view value() const
+    {
+        return string_view(text_, length);
+    }
+
+    void info() const
+    {
+        FastOutput::Writer{} << "Holder<const char[" << N << "]>(" << value() << ")\n";
+    }
+};
+
+template <size_t N>
+Holder(const char (&)[N]) -> Holder<const char[N]>;
+
+// non-owning view - never allocates
+template <>
+class Holder<string_view>
+{
+    string_view text_;
+
+public:
+    using value_type = string_view;
+
+    constexpr Holder(string_view text)
+        : text_{ text }
+    {
+    }
+
+    Holder(const char* text)
+        : text_{ text }
+    {
+    }
+
+    Holder(const std::string& text)
+        : text_{ text }
+    {
+    }
+
+    Holder(std::string&&) = delete; // would dangle
+
+    constexpr string_view value() const
+    {
+        return text_;
+    }
+
+    void info() const
+    {
+        FastOutput::Writer{} << "Holder<string_view>(" << text_ << ")\n";
     }
 };
 
@@ -277,6 +600,112 @@ TEST_CASE("Holder")
 
 } // hptr releases memory
 
+template <typename T, typename... TArgs>
+Holder<T*, PoolDeleter<T>> make_pooled(ObjectPool<T>& pool, TArgs&&... args)
+{
+    return Holder<T*, PoolDeleter<T>>(pool.create(std::forward<TArgs>(args)...), PoolDeleter<T>{pool});
+}
+
+TEST_CASE("Holder<T*> - custom deleter")
+{
+    static_assert(sizeof(Holder<int*>) == sizeof(int*)); // stateless deleter - zero size
+
+    ObjectPool<std::string> pool;
+
+    SECTION("objects are returned to the pool")
+    {
+        {
+            auto h1 = make_pooled(pool, "pooled");
+            REQUIRE(h1.value() == "pooled");
+            REQUIRE(pool.size() == 1);
+
+            auto h2 = std::move(h1);
+            REQUIRE(h2.value() == "pooled");
+            REQUIRE(pool.size() == 1);
+        }
+
+        REQUIRE(pool.size() == 0);
+    }
+
+    SECTION("slots are recycled")
+    {
+        std::string* first{};
+        {
+            auto h = make_pooled(pool, 10u, 'a');
+            first = &h.value();
+        }
+
+        auto h = make_pooled(pool, "recycled");
+        REQUIRE(&h.value() == first);
+        REQUIRE(pool.capacity() == 256);
+    }
+
+    SECTION("move assignment releases the previous object")
+    {
+        auto h1 = make_pooled(pool, "one");
+        auto h2 = make_pooled(pool, "two");
+        REQUIRE(pool.size() == 2);
+
+        h1 = std::move(h2);
+        REQUIRE(h1.value() == "two");
+        REQUIRE(pool.size() == 1);
+    }
+
+    SECTION("function pointer as deleter")
+    {
+        static int released = 0;
+        released = 0;
+
+        {
+            Holder<int*, void (*)(int*)> h(new int(7), [](int* p) { delete p; ++released; });
+            REQUIRE(h.value() == 7);
+
+            auto other = std::move(h);
+            REQUIRE(released == 0);
+        }
+
+        REQUIRE(released == 1);
+    }
+
+    SECTION("final deleter class")
+    {
+        struct FinalDeleter final
+        {
+            void operator()(int* p) const { delete p; }
+        };
+
+        Holder<int*, FinalDeleter> h(new int(8));
+        REQUIRE(h.value() == 8);
+    }
+}
+
+TEST_CASE("Holder - strings")
+{
+    Holder<const char*> ctext = "text";
+    REQUIRE(ctext.value().size() == 4);
+
+    SECTION("literal")
+    {
+        Holder literal = "literal";
+        static_assert(is_same_v<decltype(literal), Holder<const char[8]>>);
+        static_assert(decltype(literal)::length == 7);
+        static_assert(Holder{ "abc" }.value().size() == 3);
+
+        REQUIRE(literal.value() == "literal");
+    }
+
+    SECTION("string_view")
+    {
+        std::string str = "string";
+        Holder<string_view> view = str;
+
+        REQUIRE(view.value().data() == str.data());
+        REQUIRE(view.value().size() == 6);
+
+        static_assert(!is_constructible_v<Holder<string_view>, std::string&&>);
+    }
+}
+
 TEST_CASE("optional & std::in_place")
 {
     std::optional<int> opt_int = 4;
@@ -314,6 +743,107 @@ TEST_CASE("Data")
     REQUIRE(d3.item.value().size() == 4);
 }
 
+template <typename... Ts>
+struct overloaded : Ts...
+{
+    using Ts::operator()...;
+};
+
+template <typename... Ts>
+overloaded(Ts...) -> overloaded<Ts...>;
+
+// items grouped by type - one contiguous vector per alternative
+// visitor is resolved at compile time for every group (no virtual calls, no per-item dispatch)
+template <typename... Ts>
+class ItemStore
+{
+    std::tuple<std::vector<Item<Ts>>...> groups_;
+
+public:
+    using value_type = std::variant<Item<Ts>...>;
+
+    template <typename T>
+    void add(Item<T>&& item)
+    {
+        group<T>().push_back(std::move(item));
+    }
+
+    void add(value_type&& item)
+    {
+        std::visit([this](auto& alternative) { this->add(std::move(alternative)); }, item);
+    }
+
+    template <typename T, typename... TArgs>
+    Item<T>& emplace(TArgs&&... args)
+    {
+        return group<T>().emplace_back(std::forward<TArgs>(args)...);
+    }
+
+    template <typename T>
+    std::vector<Item<T>>& group()
+    {
+        return std::get<std::vector<Item<T>>>(groups_);
+    }
+
+    template <typename T>
+    const std::vector<Item<T>>& group() const
+    {
+        return std::get<std::vector<Item<T>>>(groups_);
+    }
+
+    template <typename T>
+    size_t size() const
+    {
+        return group<T>().size();
+    }
+
+    size_t size() const
+    {
+        return (size<Ts>() + ...);
+    }
+
+    template <typename Visitor>
+    void for_each(Visitor&& visitor)
+    {
+        std::apply([&visitor](auto&... groups) {
+            (..., [&visitor](auto& items) {
+                for (auto& item : items)
+                    visitor(item);
+            }(groups));
+        }, groups_);
+    }
+};
+
+TEST_CASE("ItemStore")
+{
+    ItemStore<int, double*, const char*> store;
+
+    store.add(Item{ 1 });
+    store.add(Item{ new double(3.14) });
+    store.emplace<int>(2);
+    store.emplace<const char*>("text");
+
+    decltype(store)::value_type item = Item{ 3 };
+    store.add(std::move(item));
+
+    REQUIRE(store.size() == 5);
+    REQUIRE(store.size<int>() == 3);
+
+    int sum_int = 0;
+    double sum_double = 0.0;
+    size_t length = 0;
+
+    store.for_each(overloaded{
+        [&](Item<int>& i) { sum_int += i.item.value(); },
+        [&](Item<double*>& d) { sum_double += d.item.value(); },
+        [&](Item<const char*>& t) { length += t.item.value().size(); }
+    });
+
+    REQUIRE(sum_int == 6);
+    REQUIRE(sum_double == Approx(3.14));
+    REQUIRE(length == 4);
+}
+
 template <typename T>
 struct RemoveReference
 {
@@ -355,6 +885,38 @@ TEST_CASE("sum - traits")
     REQUIRE(result == 15);
 }
 
+template <typename TContainer>
+auto parallel_sum(ThreadPool& pool, const TContainer& container)
+{
+    using ResultT = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(container))>>;
+
+    const size_t size = std::size(container);
+    const size_t chunks = std::max<size_t>(1, std::min(size, 4 * pool.size()));
+    vector<ResultT> partials(chunks, ResultT());
+
+    pool.parallel_for(0, chunks, [&](size_t chunk) {
+        auto first = std::next(std::begin(container), chunk * size / chunks);
+        auto last = std::next(std::begin(container), (chunk + 1) * size / chunks);
+
+        for (; first != last; ++first)
+            partials[chunk] += *first;
+    }, 1);
+
+    return sum(partials);
+}
+
+TEST_CASE("sum - parallel")
+{
+    ThreadPool pool{ 4 };
+
+    vector<int64_t> vec(100'000);
+    iota(vec.begin(), vec.end(), 1);
+
+    REQUIRE(parallel_sum(pool, vec) == 100'000LL * 100'001 / 2);
+    REQUIRE(parallel_sum(pool, vector<int>{}) == 0);
+    REQUIRE(parallel_sum(pool, vector{ 1, 2, 3, 4, 5 }) == 15);
+}
+
 
 template <typename T1, typename T2, size_t N>
 void my_copy(T1(&source)[N], T2(&target)[N])